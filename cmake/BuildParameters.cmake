@@ -24,7 +24,7 @@ option(GLSL_API "Replace zzogl CG backend by GLSL (experimental option)")
 option(EGL_API "Use EGL on zzogl (experimental/developer option)")
 option(GLES_API "Use GLES on GSdx (experimental/developer option)")
 option(REBUILD_SHADER "Rebuild glsl/cg shader (developer option)")
-option(BUILD_REPLAY_LOADERS "Build GS replayer to ease testing (developer option)")
+option(BUILD_REPLAY_LOADERS "Build GS and SPU2 replayers to ease testing (developer option)")
 
 #-------------------------------------------------------------------------------
 # Path and lib option
@@ -237,6 +237,11 @@ namespace HostSys
 
 	extern void Munmap( void* base, size_t size );
 
+	// Maps an entire file into memory, read-only.  Returns NULL if the file could not be
+	// opened or mapped (empty files included); size receives the length of the view.
+	extern void* MmapFile( const wxString& filename, size_t& size );
+	extern void MunmapFile( void* base, size_t size );
+
 	template< uint size >
 	void MemProtectStatic( u8 (&arr)[size], const PageProtectionMode& mode )
 	{
@@ -20,6 +20,8 @@
 #include <wx/thread.h>
 
 #include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
 #include <signal.h>
 #include <errno.h>
 #include <unistd.h>
@@ -212,6 +214,35 @@ void HostSys::Munmap(uptr base, size_t size)
 	munmap((void*)base, size);
 }
 
+void* HostSys::MmapFile( const wxString& filename, size_t& size )
+{
+	size = 0;
+
+	int fd = open(filename.fn_str(), O_RDONLY);
+	if (fd < 0) return NULL;
+
+	struct stat st;
+	void* base = NULL;
+	if ((fstat(fd, &st) == 0) && (st.st_size > 0))
+	{
+		base = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+		if (base == MAP_FAILED)
+			base = NULL;
+		else
+			size = st.st_size;
+	}
+
+	// The mapping keeps its own reference to the file.
+	close(fd);
+	return base;
+}
+
+void HostSys::MunmapFile( void* base, size_t size )
+{
+	if (!base) return;
+	munmap(base, size);
+}
+
 void HostSys::MemProtect( void* baseaddr, size_t size, const PageProtectionMode& mode )
 {
 	if (!_memprotect(baseaddr, size, mode))
@@ -134,6 +134,37 @@ void HostSys::Munmap(uptr base, size_t size)
 	VirtualFree((void*)base, 0, MEM_RELEASE);
 }
 
+void* HostSys::MmapFile( const wxString& filename, size_t& size )
+{
+	size = 0;
+
+	HANDLE file = CreateFileW(filename.wc_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE) return NULL;
+
+	void* base = NULL;
+	LARGE_INTEGER length;
+	if (GetFileSizeEx(file, &length) && (length.QuadPart > 0) && (length.QuadPart <= (LONGLONG)(size_t)-1))
+	{
+		if (HANDLE mapping = CreateFileMapping(file, NULL, PAGE_READONLY, 0, 0, NULL))
+		{
+			base = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+			if (base) size = (size_t)length.QuadPart;
+
+			// The view keeps its own references to the mapping and the file.
+			CloseHandle(mapping);
+		}
+	}
+
+	CloseHandle(file);
+	return base;
+}
+
+void HostSys::MunmapFile( void* base, size_t size )
+{
+	if (!base) return;
+	UnmapViewOfFile(base);
+}
+
 void HostSys::MemProtect( void* baseaddr, size_t size, const PageProtectionMode& mode )
 {
 	pxAssertDev( ((size & (__pagesize-1)) == 0), pxsFmt(
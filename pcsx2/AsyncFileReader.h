@@ -50,6 +50,15 @@ public:
 	virtual void SetBlockSize(uint bytes) {}
 	virtual void SetDataOffset(int bytes) {}
 
+	// Readers that map the image into memory can hand out pointers to the blocks directly,
+	// saving the copy through a read buffer.  A pointer stays valid until the next call on
+	// the reader; NULL means the block has to be read with ReadSync/BeginRead instead.
+	virtual bool IsMapped() const { return false; }
+	virtual const u8* GetBlockPtr(uint sector) { return NULL; }
+
+	// Hints that the given blocks are about to be accessed through GetBlockPtr.
+	virtual void Prefetch(uint sector, uint count) {}
+
 	uint GetBlockSize() const { return m_blocksize; }
 
 	const wxString& GetFilename() const
@@ -70,11 +79,28 @@ class FlatFileReader : public AsyncFileReader
 	HANDLE hEvent;
 
 	bool asyncInProgress;
+	HANDLE hMapping;
 #else
 	int m_fd; // FIXME don't know if overlap as an equivalent on linux
 	io_context_t m_aio_context;
 #endif
 
+	// Mapped mode (EmuConfig.CdvdMapImages): the file is accessed through a window of
+	// MapWindowSize bytes, moved along as needed.  Windows are aligned to MapAlign, which
+	// satisfies the mapping granularity of both platforms.
+	static const uint MapWindowSize	= 32 * _1mb;
+	static const uint MapAlign		= _1mb;
+
+	bool	m_mapped;
+	s64		m_filesize;
+	u8*		m_view;
+	s64		m_viewoffset;
+	uint	m_viewsize;
+	int		m_viewresult;		// result of a BeginRead served from the view, or -2 if none
+
+	const u8* MapBlocks(uint sector, uint count);
+	void UnmapView();
+
 public:
 	FlatFileReader(void);
 	virtual ~FlatFileReader(void);
@@ -93,6 +119,10 @@ public:
 
 	virtual void SetBlockSize(uint bytes) { m_blocksize = bytes; }
 	virtual void SetDataOffset(int bytes) { m_dataoffset = bytes; }
+
+	virtual bool IsMapped() const { return m_mapped; }
+	virtual const u8* GetBlockPtr(uint sector) { return MapBlocks(sector, 1); }
+	virtual void Prefetch(uint sector, uint count);
 };
 
 // Factory - creates an AsyncFileReader derived instance which can read a compressed file
@@ -146,6 +176,10 @@ public:
 
 	virtual void SetBlockSize(uint bytes);
 
+	virtual bool IsMapped() const;
+	virtual const u8* GetBlockPtr(uint sector);
+	virtual void Prefetch(uint sector, uint count);
+
 	static AsyncFileReader* DetectMultipart(AsyncFileReader* reader);
 };
 
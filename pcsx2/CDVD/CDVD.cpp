@@ -1211,6 +1211,7 @@ static void cdvdWrite04(u8 rt) { // NCOMMAND
 			cdvd.Action = cdvdAction_Seek;
 			cdvd.ReadTime = cdvdBlockReadTime( MODE_DVDROM );
 			CDVD_INT( cdvdStartSeek( *(uint*)(cdvd.Param+0), MODE_DVDROM ) );
+			DoCDVDprefetch( cdvd.SeekToSector, 0 );
 		break;
 
 		case N_CD_READ: // CdRead
@@ -1241,6 +1242,7 @@ static void cdvdWrite04(u8 rt) { // NCOMMAND
 			// This helps improve performance on actual from-cd emulation
 			// (ie, not using the hard drive)
 			cdvd.RErr = DoCDVDreadTrack( cdvd.SeekToSector, cdvd.ReadMode );
+			DoCDVDprefetch( cdvd.SeekToSector, cdvd.nSectors );
 
 			// Set the reading block flag.  If a seek is pending then Readed will
 			// take priority in the handler anyway.  If the read is contiguous then
@@ -1289,6 +1291,7 @@ static void cdvdWrite04(u8 rt) { // NCOMMAND
 			// This helps improve performance on actual from-cd emulation
 			// (ie, not using the hard drive)
 			cdvd.RErr = DoCDVDreadTrack( cdvd.SeekToSector, cdvd.ReadMode );
+			DoCDVDprefetch( cdvd.SeekToSector, cdvd.nSectors );
 
 			// Set the reading block flag.  If a seek is pending then Readed will
 			// take priority in the handler anyway.  If the read is contiguous then
@@ -1325,6 +1328,7 @@ static void cdvdWrite04(u8 rt) { // NCOMMAND
 			// This helps improve performance on actual from-cd emulation
 			// (ie, not using the hard drive)
 			cdvd.RErr = DoCDVDreadTrack( cdvd.SeekToSector, cdvd.ReadMode );
+			DoCDVDprefetch( cdvd.SeekToSector, cdvd.nSectors );
 
 			// Set the reading block flag.  If a seek is pending then Readed will
 			// take priority in the handler anyway.  If the read is contiguous then
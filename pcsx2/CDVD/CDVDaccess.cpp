@@ -483,6 +483,13 @@ s32 DoCDVDgetBuffer(u8* buffer)
 	return ret;
 }
 
+void DoCDVDprefetch(u32 lsn, u32 count)
+{
+	CheckNullCDVD();
+	if (CDVD->prefetch != NULL)
+		CDVD->prefetch(lsn, count);
+}
+
 s32 DoCDVDdetectDiskType()
 {
 	CheckNullCDVD();
@@ -595,4 +602,5 @@ CDVD_API CDVDapi_NoDisc =
 	NODISCreadSector,
 	NODISCgetBuffer2,
 	NODISCgetDualInfo,
+	NULL,		// prefetch
 };
@@ -51,6 +51,9 @@ struct CDVD_API
 	_CDVDreadSector    readSector;
 	_CDVDgetBuffer2    getBuffer2;
 	_CDVDgetDualInfo   getDualInfo;
+
+	// Optional (may be NULL): hints the target of a seek or read before it is due.
+	void (CALLBACK *prefetch)(u32 lsn, u32 count);
 };
 
 // ----------------------------------------------------------------------------
@@ -77,6 +80,7 @@ extern void DoCDVDclose();
 extern s32  DoCDVDreadSector(u8* buffer, u32 lsn, int mode);
 extern s32  DoCDVDreadTrack(u32 lsn, int mode);
 extern s32  DoCDVDgetBuffer(u8* buffer);
+extern void DoCDVDprefetch(u32 lsn, u32 count);
 extern s32  DoCDVDdetectDiskType();
 extern void DoCDVDresetDiskTypeCache();
 
@@ -27,21 +27,42 @@
 #include <fcntl.h>
 
 #include "CDVDisoReader.h"
+#include "IsoSectorCache.h"
 
 #include "AsyncFileReader.h"
 
 static InputIsoFile iso;
+static ScopedPtr<IsoSectorCache> isoCache;
+static Mutex isoCacheLock;		// held while isoCache changes, for ISOgetCacheStats
 
 static int pmode, cdtype;
+static u32 plsn;
 
 static s32 layer1start = -1;
 static bool layer1searched = false;
 
 void CALLBACK ISOclose()
 {
+	if( isoCache )
+	{
+		isoCache->Stop();
+		isoCache->GetStats().Log();
+
+		ScopedLock lock( isoCacheLock );
+		isoCache = NULL;
+	}
+
 	iso.Close();
 }
 
+// Reads a sector straight from the image, for the few places that don't go through the
+// CDVD read commands.  Must not overlap with the prefetcher's reads.
+static int isoReadSync( u8* dst, uint lsn )
+{
+	ScopedLock lock( isoCache ? &isoCache->GetIoLock() : NULL );
+	return iso.ReadSync( dst, lsn );
+}
+
 s32 CALLBACK ISOopen(const char* pTitle)
 {
 	ISOclose();		// just in case
@@ -79,10 +100,28 @@ s32 CALLBACK ISOopen(const char* pTitle)
 
 	layer1start = -1;
 	layer1searched = false;
+
+	// Mapped images are read straight from the page cache; the prefetcher would only add
+	// a copy there.
+	if( EmuConfig.CdvdPrefetch && !iso.IsMapped() )
+	{
+		ScopedLock lock( isoCacheLock );
+		isoCache = new IsoSectorCache( iso );
+		isoCache->Start();
+	}
 	
 	return 0;
 }
 
+bool ISOgetCacheStats( IsoSectorCacheStats& dest )
+{
+	ScopedLock lock( isoCacheLock );
+	if( !isoCache ) return false;
+
+	dest = isoCache->GetStats();
+	return true;
+}
+
 s32 CALLBACK ISOreadSubQ(u32 lsn, cdvdSubQ* subq)
 {
 	// fake it
@@ -172,7 +211,7 @@ static void FindLayer1Start()
 	if( blockresult != -1 )
 	{
 		u8 tempbuffer[CD_FRAMESIZE_RAW];
-		iso.ReadSync(tempbuffer, blockresult);
+		isoReadSync(tempbuffer, blockresult);
 
 		if( testForPartitionInfo( tempbuffer ) )
 		{
@@ -212,13 +251,13 @@ static void FindLayer1Start()
 		while( (layer1start == -1) && (deviation < midsector-16) )
 		{
 			u8 tempbuffer[CD_FRAMESIZE_RAW];
-			iso.ReadSync(tempbuffer, midsector-deviation);
+			isoReadSync(tempbuffer, midsector-deviation);
 
 			if(testForPartitionInfo( tempbuffer ))
 				layer1start = midsector-deviation;
 			else
 			{
-				iso.ReadSync(tempbuffer, midsector+deviation);
+				isoReadSync(tempbuffer, midsector+deviation);
 				if( testForPartitionInfo( tempbuffer ) )
 					layer1start = midsector+deviation;
 			}
@@ -389,10 +428,13 @@ s32 CALLBACK ISOreadSector(u8* tempbuffer, u32 lsn, int mode)
 
 	if(mode == CDVD_MODE_2352)
 	{
-		iso.ReadSync(tempbuffer, lsn);
+		isoReadSync(tempbuffer, lsn);
 		return 0;
 	}
 
+	if (isoCache)
+		return isoCache->Read(tempbuffer, lsn, mode);
+
 	iso.ReadSync(cdbuffer, lsn);
 
 	
@@ -434,7 +476,11 @@ s32 CALLBACK ISOreadTrack(u32 lsn, int mode)
 	if (_lsn < 0) lsn = iso.GetBlockCount() + _lsn;
 	if (lsn > iso.GetBlockCount()) return -1;
 
-	iso.BeginRead2(lsn);
+	// With the prefetcher running the sector is fetched (or waited for) by getBuffer2.
+	if (isoCache)
+		plsn = lsn;
+	else
+		iso.BeginRead2(lsn);
 
 	pmode = mode;
 
@@ -443,9 +489,22 @@ s32 CALLBACK ISOreadTrack(u32 lsn, int mode)
 
 s32 CALLBACK ISOgetBuffer2(u8* buffer)
 {
+	if (isoCache)
+		return isoCache->Read(buffer, plsn, pmode);
+
 	return iso.FinishRead3(buffer, pmode);
 }
 
+// Seek and read commands announce their target here, well before the emulated drive gets
+// there.
+void CALLBACK ISOprefetch(u32 lsn, u32 count)
+{
+	if (isoCache)
+		isoCache->Prefetch(lsn, count);
+	else
+		iso.Prefetch(lsn, count);
+}
+
 //u8* CALLBACK ISOgetBuffer()
 //{
 //	iso.FinishRead();
@@ -496,4 +555,5 @@ CDVD_API CDVDapi_Iso =
 	ISOreadSector,
 	ISOgetBuffer2,
 	ISOgetDualInfo,
+	ISOprefetch,
 };
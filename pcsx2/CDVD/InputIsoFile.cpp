@@ -84,18 +84,45 @@ void InputIsoFile::BeginRead2(uint lsn)
 		m_read_count = min(ReadUnit, m_blocks - m_read_lsn);
 	}
 
+	if(m_reader->IsMapped())
+	{
+		// Nothing to read: FinishRead3 copies straight out of the mapping.  Just let the
+		// OS know which part of the image comes next.
+		m_read_direct = true;
+		m_reader->Prefetch(m_read_lsn, m_read_count);
+		return;
+	}
+
+	m_read_direct = false;
 	m_reader->BeginRead(m_readbuffer, m_read_lsn, m_read_count);
 	m_read_inprogress = true;
 }
 
 int InputIsoFile::FinishRead3(u8* dst, uint mode)
 {
-	int _offset, length;
 	int ret = 0;
 
 	if(m_current_lsn < 0)
 		return -1;
 
+	if(m_read_direct)
+	{
+		if(const u8* src = m_reader->GetBlockPtr(m_current_lsn))
+		{
+			CopyBlock(dst, src, m_current_lsn, mode);
+			return 0;
+		}
+
+		// The mapping failed; the reader has gone back to regular reads.
+		m_read_direct = false;
+		m_read_lsn = m_current_lsn;
+		m_read_count = 1;
+
+		ret = m_reader->ReadSync(m_readbuffer, m_read_lsn, 1);
+		if(ret < 0)
+			return ret;
+	}
+
 	if(m_read_inprogress)
 	{
 		ret = m_reader->FinishRead();
@@ -104,7 +131,45 @@ int InputIsoFile::FinishRead3(u8* dst, uint mode)
 		if(ret < 0)
 			return ret;
 	}
-		
+
+	uint read_offset = (m_current_lsn - m_read_lsn) * m_blocksize;
+	CopyBlock(dst, m_readbuffer + read_offset, m_current_lsn, mode);
+
+	return 0;
+}
+
+// Reads count consecutive blocks, as stored in the image (GetBlockSize() bytes each).
+// Use CopyBlock to format them for the CDVD.
+int InputIsoFile::ReadBlocks(u8* dst, uint lsn, uint count)
+{
+	if (lsn + count > m_blocks)
+	{
+		Console.Error("isoFile error: Block range is past the end of file! (%u+%u > %u).", lsn, count, m_blocks);
+		return -1;
+	}
+
+	return m_reader->ReadSync(dst, lsn, count);
+}
+
+// Hints that the given sectors are about to be read.  Only of use for mapped images, which
+// have no read of their own to start early.
+void InputIsoFile::Prefetch(uint lsn, uint count)
+{
+	static const uint MaxPrefetch = 16 * MaxReadUnit;
+
+	if (lsn >= m_blocks) return;
+	if (count == 0) count = ReadUnit;
+	if (count > MaxPrefetch) count = MaxPrefetch;
+	if (count > m_blocks - lsn) count = m_blocks - lsn;
+
+	m_reader->Prefetch(lsn, count);
+}
+
+// Formats one block read from the image into the layout of the given CDVD read mode.
+void InputIsoFile::CopyBlock(u8* dst, const u8* src, uint lsn, uint mode) const
+{
+	int _offset, length;
+
 	switch (mode)
 	{
 	case CDVD_MODE_2352:
@@ -144,16 +209,13 @@ int InputIsoFile::FinishRead3(u8* dst, uint mode)
 
 	length = end - _offset;
 
-	uint read_offset = (m_current_lsn - m_read_lsn) * m_blocksize;
-	memcpy_fast(dst + diff, m_readbuffer + ndiff + read_offset, length);
+	memcpy_fast(dst + diff, src + ndiff, length);
 	
 	if (m_type == ISOTYPE_CD && diff >= 12)
 	{
-		lsn_to_msf(dst + diff - 12, m_current_lsn);
+		lsn_to_msf(dst + diff - 12, lsn);
 		dst[diff - 9] = 2;
 	}
-
-	return 0;
 }
 
 InputIsoFile::InputIsoFile()
@@ -177,6 +239,7 @@ void InputIsoFile::_init()
 	m_blocks		= 0;
 	
 	m_read_inprogress = false;
+	m_read_direct = false;
 	m_read_count = 0;
 	m_read_lsn = -1;
 }
@@ -15,12 +15,55 @@
 
 #pragma once
 
+#include <map>
+
 enum IsoFS_Type
 {
 	FStype_ISO9660	= 1,
 	FStype_Joliet	= 2,
 };
 
+// --------------------------------------------------------------------------------------
+//  IsoFSIndex
+// --------------------------------------------------------------------------------------
+// Disk cache of an image's directory records, so that walking the filesystem of an image
+// that was seen before needs no directory sector reads at all (those are slow on compressed
+// and network-hosted images).  There is one index file per image in the cache folder, and
+// it is memory-mapped while in use.  An index is dropped when its image's size or modification
+// time changes.  Directories read from the image during a walk are added to the index file
+// when the walk ends.
+//
+// Directories are keyed by their starting lba and stored as their raw ISO9660 records.
+// Lba 0 (the system area, never a directory) holds the filesystem type followed by the
+// root directory record.
+class IsoFSIndex
+{
+	DeclareNoncopyableObject( IsoFSIndex );
+
+protected:
+	wxString	m_imagePath;
+	wxString	m_filename;		// index file, or empty if the image can't be indexed
+	s64			m_imageTime;
+	u64			m_imageSize;
+
+	const u8*	m_view;
+	size_t		m_viewSize;
+
+	std::map< u32, std::vector<u8> >	m_added;
+
+public:
+	IsoFSIndex( const wxString& imagePath );
+	virtual ~IsoFSIndex() throw();
+
+	bool Find( u32 lba, const u8*& data, u32& size ) const;
+	void Add( u32 lba, const u8* data, u32 size );
+
+protected:
+	void Open();
+	void Close();
+	void Flush();
+};
+
 class IsoDirectory
 {
 public:
@@ -28,9 +71,13 @@ public:
 	std::vector<IsoFileDescriptor>	files;
 	IsoFS_Type						m_fstype;
 
+protected:
+	ScopedPtr<IsoFSIndex>			m_ownIndex;		// root directories own the index of their walk
+	IsoFSIndex*						m_index;		// may be NULL
+
 public:
 	IsoDirectory(SectorSource& r);
-	IsoDirectory(SectorSource& r, IsoFileDescriptor directoryEntry);
+	IsoDirectory(SectorSource& r, IsoFileDescriptor directoryEntry, IsoFSIndex* index = NULL);
 	virtual ~IsoDirectory() throw();
 
 	wxString FStype_ToString() const;
@@ -18,6 +18,201 @@
 
 #include "IsoFS.h"
 #include "IsoFile.h"
+#include "AppConfig.h"
+
+#include <wx/ffile.h>
+
+//////////////////////////////////////////////////////////////////////////
+// IsoFSIndex
+//////////////////////////////////////////////////////////////////////////
+
+// Index file layout: the header, the image path (UTF-8, padded to 4 bytes), a table of
+// IsoFSIndexDir sorted by lba, then the directory records themselves.
+
+static const u32 IsoFSIndexMagic	= 0x58534649;	// "IFSX"
+static const u32 IsoFSIndexVersion	= 1;
+
+struct IsoFSIndexHeader
+{
+	u32		Magic;
+	u32		Version;
+	s64		ImageTime;
+	u64		ImageSize;
+	u32		FileSize;
+	u32		PathLength;
+	u32		DirCount;
+	u32		Dirs;
+};
+
+struct IsoFSIndexDir
+{
+	u32		lba;
+	u32		offset;
+	u32		size;
+};
+
+static bool operator<( const IsoFSIndexDir& dir, u32 lba ) { return dir.lba < lba; }
+
+// Serializes index file replacement between threads walking the same image.
+static Mutex s_mtx_IsoFSIndexWrite;
+
+IsoFSIndex::IsoFSIndex( const wxString& imagePath )
+	: m_imagePath( imagePath )
+{
+	m_view		= NULL;
+	m_viewSize	= 0;
+	m_imageTime	= 0;
+	m_imageSize	= 0;
+
+	wxFileName image( imagePath );
+	if( !image.FileExists() ) return;
+
+	image.MakeAbsolute();
+	m_imagePath = image.GetFullPath();
+	m_imageTime = image.GetModificationTime().GetValue().GetValue();
+	m_imageSize = image.GetSize().GetValue();
+
+	const wxCharBuffer utf8( m_imagePath.ToUTF8() );
+	const wxString name( wxsFormat( L"%08x.isoidx", HashTools::Hash( utf8.data(), strlen(utf8.data()) ) ) );
+	m_filename = GetCacheFolder().Combine( wxFileName(name) ).GetFullPath();
+
+	Open();
+}
+
+IsoFSIndex::~IsoFSIndex() throw()
+{
+	if( !m_added.empty() ) Flush();
+	Close();
+}
+
+void IsoFSIndex::Open()
+{
+	m_view = (const u8*)HostSys::MmapFile( m_filename, m_viewSize );
+	if( !m_view ) return;
+
+	const IsoFSIndexHeader& hdr( *(const IsoFSIndexHeader*)m_view );
+	const u32 pathSize = (hdr.PathLength + 3) & ~3;
+
+	bool valid = m_viewSize >= sizeof(hdr)
+		&& hdr.Magic == IsoFSIndexMagic && hdr.Version == IsoFSIndexVersion
+		&& hdr.FileSize == m_viewSize
+		&& hdr.ImageTime == m_imageTime && hdr.ImageSize == m_imageSize
+		&& hdr.Dirs == sizeof(hdr) + (u64)pathSize
+		&& (u64)hdr.Dirs + (u64)hdr.DirCount * sizeof(IsoFSIndexDir) <= m_viewSize;
+
+	// Different images can share a file name; the full path tells them apart.
+	if( valid )
+		valid = wxString::FromUTF8( (const char*)&m_view[sizeof(hdr)], hdr.PathLength ) == m_imagePath;
+
+	if( !valid ) Close();
+}
+
+void IsoFSIndex::Close()
+{
+	HostSys::MunmapFile( (void*)m_view, m_viewSize );
+	m_view		= NULL;
+	m_viewSize	= 0;
+}
+
+bool IsoFSIndex::Find( u32 lba, const u8*& data, u32& size ) const
+{
+	std::map< u32, std::vector<u8> >::const_iterator added( m_added.find(lba) );
+	if( added != m_added.end() )
+	{
+		data = added->second.empty() ? NULL : &added->second[0];
+		size = added->second.size();
+		return true;
+	}
+
+	if( !m_view ) return false;
+
+	const IsoFSIndexHeader& hdr( *(const IsoFSIndexHeader*)m_view );
+	const IsoFSIndexDir* dirs = (const IsoFSIndexDir*)&m_view[hdr.Dirs];
+	const IsoFSIndexDir* dir = std::lower_bound( dirs, dirs + hdr.DirCount, lba );
+
+	if( dir == dirs + hdr.DirCount || dir->lba != lba ) return false;
+	if( (u64)dir->offset + dir->size > m_viewSize ) return false;
+
+	data = &m_view[dir->offset];
+	size = dir->size;
+	return true;
+}
+
+void IsoFSIndex::Add( u32 lba, const u8* data, u32 size )
+{
+	if( m_filename.IsEmpty() ) return;
+	m_added[lba].assign( data, data + size );
+}
+
+// Rewrites the index file with the mapped directories plus the ones added since.  The old
+// view is released first: a mapped file can't be replaced on Windows.
+void IsoFSIndex::Flush()
+{
+	std::map< u32, std::vector<u8> > dirs;
+	if( m_view )
+	{
+		const IsoFSIndexHeader& hdr( *(const IsoFSIndexHeader*)m_view );
+		const IsoFSIndexDir* table = (const IsoFSIndexDir*)&m_view[hdr.Dirs];
+		for( u32 i=0; i<hdr.DirCount; ++i )
+		{
+			if( (u64)table[i].offset + table[i].size > m_viewSize ) continue;
+			dirs[table[i].lba].assign( &m_view[table[i].offset], &m_view[table[i].offset] + table[i].size );
+		}
+	}
+	Close();
+
+	for( std::map< u32, std::vector<u8> >::const_iterator it( m_added.begin() ); it != m_added.end(); ++it )
+		dirs[it->first] = it->second;
+	m_added.clear();
+
+	const wxCharBuffer path( m_imagePath.ToUTF8() );
+
+	IsoFSIndexHeader hdr;
+	memzero( hdr );
+	hdr.Magic		= IsoFSIndexMagic;
+	hdr.Version		= IsoFSIndexVersion;
+	hdr.ImageTime	= m_imageTime;
+	hdr.ImageSize	= m_imageSize;
+	hdr.PathLength	= strlen( path.data() );
+	hdr.DirCount	= dirs.size();
+	hdr.Dirs		= sizeof(hdr) + ((hdr.PathLength + 3) & ~3);
+
+	std::vector<IsoFSIndexDir> table;
+	table.reserve( dirs.size() );
+
+	u32 offset = hdr.Dirs + hdr.DirCount * sizeof(IsoFSIndexDir);
+	for( std::map< u32, std::vector<u8> >::const_iterator it( dirs.begin() ); it != dirs.end(); ++it )
+	{
+		IsoFSIndexDir dir = { it->first, offset, (u32)it->second.size() };
+		table.push_back( dir );
+		offset += it->second.size();
+	}
+	hdr.FileSize = offset;
+
+	ScopedLock lock( s_mtx_IsoFSIndexWrite );
+
+	GetCacheFolder().Mkdir();
+
+	const wxString tmpfile( m_filename + L".tmp" );
+	wxFFile out( tmpfile, L"wb" );
+	if( !out.IsOpened() ) return;
+
+	static const u8 padding[4] = { 0 };
+	bool ok = out.Write( &hdr, sizeof(hdr) ) == sizeof(hdr);
+	ok = ok && out.Write( path.data(), hdr.PathLength ) == hdr.PathLength;
+	ok = ok && out.Write( padding, hdr.Dirs - sizeof(hdr) - hdr.PathLength ) == hdr.Dirs - sizeof(hdr) - hdr.PathLength;
+	if( !table.empty() )
+		ok = ok && out.Write( &table[0], table.size() * sizeof(IsoFSIndexDir) ) == table.size() * sizeof(IsoFSIndexDir);
+	for( std::map< u32, std::vector<u8> >::const_iterator it( dirs.begin() ); ok && it != dirs.end(); ++it )
+		ok = it->second.empty() || out.Write( &it->second[0], it->second.size() ) == it->second.size();
+	ok = out.Close() && ok;
+
+	if( !ok || !wxRenameFile( tmpfile, m_filename, true ) )
+	{
+		Console.Warning( L"(IsoFS) Could not write the filesystem index [%s]", WX_STR(m_filename) );
+		wxRemoveFile( tmpfile );
+	}
+}
 
 //////////////////////////////////////////////////////////////////////////
 // IsoDirectory
@@ -49,6 +244,24 @@ IsoDirectory::IsoDirectory(SectorSource& r)
 
 	m_fstype = FStype_ISO9660;
 
+	const wxString imagePath( r.getImagePath() );
+	if( !imagePath.IsEmpty() )
+		m_ownIndex = new IsoFSIndex( imagePath );
+	m_index = m_ownIndex;
+
+	// Lba 0 of the index holds the filesystem type and the root directory record.
+	u8 rootRecord[39];
+	const u8* cached;
+	u32 cachedSize;
+
+	if( m_index && m_index->Find( 0, cached, cachedSize ) && cachedSize == sizeof(rootRecord) )
+	{
+		m_fstype = (IsoFS_Type)cached[0];
+		rootDirEntry.Load( cached+1, 38 );
+		Init( rootDirEntry );
+		return;
+	}
+
 	while( !done )
 	{
 		u8 sector[2048];
@@ -64,6 +277,7 @@ IsoDirectory::IsoDirectory(SectorSource& r)
                 case 1:
                     DevCon.WriteLn( "(IsoFS) Block 0x%x: Primary partition info.", i );
                     rootDirEntry.Load( sector+156, 38 );
+                    memcpy( rootRecord+1, sector+156, 38 );
                     isValid = true;
                     break;
 
@@ -98,13 +312,22 @@ IsoDirectory::IsoDirectory(SectorSource& r)
 			.SetDiagMsg(L"IsoFS could not find the root directory on the ISO image.");
 
 	DevCon.WriteLn( L"(IsoFS) Filesystem is " + FStype_ToString() );
+
+	if( m_index )
+	{
+		rootRecord[0] = m_fstype;
+		m_index->Add( 0, rootRecord, sizeof(rootRecord) );
+	}
+
 	Init( rootDirEntry );
 }
 
 // Used to load a specific directory from a file descriptor
-IsoDirectory::IsoDirectory(SectorSource& r, IsoFileDescriptor directoryEntry)
+IsoDirectory::IsoDirectory(SectorSource& r, IsoFileDescriptor directoryEntry, IsoFSIndex* index)
 	: internalReader(r)
+	, m_index(index)
 {
+	m_fstype = FStype_ISO9660;
 	Init(directoryEntry);
 }
 
@@ -114,14 +337,26 @@ IsoDirectory::~IsoDirectory() throw()
 
 void IsoDirectory::Init(const IsoFileDescriptor& directoryEntry)
 {
+	files.clear();
+
+	const u8* cached;
+	u32 cachedSize;
+	if( m_index && m_index->Find( directoryEntry.lba, cached, cachedSize ) )
+	{
+		// Records shorter than the fixed part of a directory record (34 bytes) can only
+		// come from a damaged index; stop there.
+		for( u32 pos=0; pos < cachedSize && cached[pos] >= 34 && pos + cached[pos] <= cachedSize; pos += cached[pos] )
+			files.push_back(IsoFileDescriptor(cached + pos, cached[pos]));
+		return;
+	}
+
 	// parse directory sector
 	IsoFile dataStream (internalReader, directoryEntry);
 
-	files.clear();
-
 	uint remainingSize = directoryEntry.size;
 
 	u8 b[257];
+	std::vector<u8> records;
 
 	while(remainingSize>=4) // hm hack :P
 	{
@@ -137,9 +372,12 @@ void IsoDirectory::Init(const IsoFileDescriptor& directoryEntry)
 		dataStream.read(b+1, b[0]-1);
 
 		files.push_back(IsoFileDescriptor(b, b[0]));
+		records.insert(records.end(), b, b + b[0]);
 	}
 
 	b[0] = 0;
+
+	if( m_index ) m_index->Add( directoryEntry.lba, records.empty() ? NULL : &records[0], records.size() );
 }
 
 const IsoFileDescriptor& IsoDirectory::GetEntry(int index) const
@@ -181,7 +419,7 @@ IsoFileDescriptor IsoDirectory::FindFile(const wxString& filePath) const
 		info = dir->GetEntry(parts.GetDirs()[i]);
 		if(info.IsFile()) throw Exception::FileNotFound( filePath );
 
-		dir = deleteme = new IsoDirectory(internalReader, info);
+		dir = deleteme = new IsoDirectory(internalReader, info, m_index);
 	}
 
 	if( !parts.GetFullName().IsEmpty() )
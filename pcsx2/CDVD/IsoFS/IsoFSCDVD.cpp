@@ -36,6 +36,13 @@ int IsoFSCDVD::getNumSectors()
 	return td.lsn;
 }
 
+wxString IsoFSCDVD::getImagePath()
+{
+	// Plugins can swap discs without telling us; only ISO images are indexed.
+	if (CDVDsys_GetSourceType() != CDVDsrc_Iso) return wxEmptyString;
+	return CDVDsys_GetFile(CDVDsrc_Iso);
+}
+
 IsoFSCDVD::~IsoFSCDVD() throw()
 {
 }
@@ -20,5 +20,11 @@ class SectorSource
 public:
 	virtual int  getNumSectors()=0;
 	virtual bool readSector(unsigned char* buffer, int lba)=0;
+
+	// Path of the image file behind this source, used to find its IsoFSIndex.  Sources that
+	// can't be tied to a file (or whose disc can change underneath them) return an empty
+	// string, and are never indexed.
+	virtual wxString getImagePath() { return wxEmptyString; }
+
 	virtual ~SectorSource() throw() {}
 };
@@ -60,6 +60,7 @@ protected:
 	u32			m_blocks;
 		
 	bool		m_read_inprogress;
+	bool		m_read_direct;		// mapped image: sectors are copied from the reader's mapping
 	uint		m_read_lsn;
 	uint		m_read_count;
 	u8			m_readbuffer[MaxReadUnit * CD_FRAMESIZE_RAW];
@@ -73,6 +74,8 @@ public:
 	isoType GetType() const		{ return m_type; }
 	uint GetBlockCount() const	{ return m_blocks; }	
 	int GetBlockOffset() const	{ return m_blockofs; }
+	uint GetBlockSize() const	{ return m_blocksize; }
+	bool IsMapped() const		{ return m_reader->IsMapped(); }
 	
 	const wxString& GetFilename() const
 	{
@@ -88,6 +91,10 @@ public:
 
 	void BeginRead2(uint lsn);
 	int FinishRead3(u8* dest, uint mode);
+
+	int ReadBlocks(u8* dst, uint lsn, uint count);
+	void Prefetch(uint lsn, uint count);
+	void CopyBlock(u8* dst, const u8* src, uint lsn, uint mode) const;
 	
 protected:
 	void _init();
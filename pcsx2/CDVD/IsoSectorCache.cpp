@@ -0,0 +1,306 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2014  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PrecompiledHeader.h"
+#include "IopCommon.h"
+#include "IsoSectorCache.h"
+
+// --------------------------------------------------------------------------------------
+//  IsoSectorCacheStats  (implementations)
+// --------------------------------------------------------------------------------------
+void IsoSectorCacheStats::RecordLatency( u64 ticks )
+{
+	const u64 us = (ticks * 1000000) / GetTickFrequency();
+
+	int bucket = 0;
+	while( (bucket < LatencyBuckets-1) && (us >= (64ULL << bucket)) ) ++bucket;
+	++Latency[bucket];
+}
+
+// Returns the upper bound, in microseconds, of the latency bucket the given percentile
+// of host reads falls in.
+u32 IsoSectorCacheStats::GetLatencyPercentile( uint percent ) const
+{
+	const u64 target = ((u64)HostReads * percent + 99) / 100;
+
+	u64 count = 0;
+	for( int bucket=0; bucket<LatencyBuckets; ++bucket )
+	{
+		count += Latency[bucket];
+		if( count >= target ) return 64 << bucket;
+	}
+	return 64 << (LatencyBuckets-1);
+}
+
+u32 IsoSectorCacheStats::GetHitPercent() const
+{
+	return Requests ? (u32)(((u64)Hits * 100) / Requests) : 100;
+}
+
+void IsoSectorCacheStats::Log() const
+{
+	if( !Requests ) return;
+
+	Console.WriteLn( "(IsoCache) %u sectors read, %u%% cached in time, %u stalls (%ums total)",
+		Requests, GetHitPercent(), Stalls, (u32)((StallTicks * 1000) / GetTickFrequency()) );
+
+	if( !HostReads ) return;
+
+	Console.WriteLn( "(IsoCache) %u host reads (%u retried by sector), latency p50 < %uus, p90 < %uus, p99 < %uus",
+		HostReads, HostErrors, GetLatencyPercentile(50), GetLatencyPercentile(90), GetLatencyPercentile(99) );
+}
+
+// --------------------------------------------------------------------------------------
+//  IsoSectorCache  (implementations)
+// --------------------------------------------------------------------------------------
+IsoSectorCache::IsoSectorCache( InputIsoFile& iso )
+	: _parent( L"CDVD Prefetch" )
+	, m_iso( iso )
+	, m_buffer( NumChunks * ChunkSectors * iso.GetBlockSize() )
+{
+	for( uint i=0; i<NumChunks; ++i )
+	{
+		m_chunks[i].Index	= 0;
+		m_chunks[i].State	= Chunk_Empty;
+		m_chunks[i].LastUse	= 0;
+		m_chunks[i].Valid	= 0;
+		m_chunks[i].Data	= m_buffer.GetPtr() + i * ChunkSectors * iso.GetBlockSize();
+	}
+
+	m_lastChunk	= 0;
+	m_useCount	= 0;
+	m_lastLsn	= (u32)-1;
+	m_quit		= false;
+
+	m_stats.Reset();
+}
+
+IsoSectorCache::~IsoSectorCache() throw()
+{
+	_parent::Cancel();
+}
+
+// Not done through Cancel(), since cancelling the thread in the middle of an image read
+// could leave the reader in an undefined state.
+void IsoSectorCache::Stop()
+{
+	m_quit = true;
+	m_sem_event.Post();
+	Block();
+}
+
+IsoSectorCacheStats IsoSectorCache::GetStats()
+{
+	ScopedLock lock( m_lock );
+	return m_stats;
+}
+
+int IsoSectorCache::FindChunk( u32 index ) const
+{
+	if( (m_chunks[m_lastChunk].State != Chunk_Empty) && (m_chunks[m_lastChunk].Index == index) )
+		return m_lastChunk;
+
+	for( uint i=0; i<NumChunks; ++i )
+	{
+		if( (m_chunks[i].State != Chunk_Empty) && (m_chunks[i].Index == index) ) return i;
+	}
+	return -1;
+}
+
+// Picks an empty slot, or else the least recently used one.  The chunk being loaded is
+// never picked (there is only ever one).
+int IsoSectorCache::AllocChunk()
+{
+	int victim = -1;
+	for( uint i=0; i<NumChunks; ++i )
+	{
+		if( m_chunks[i].State == Chunk_Empty ) return i;
+		if( m_chunks[i].State == Chunk_Loading ) continue;
+
+		if( (victim < 0) || (m_chunks[i].LastUse < m_chunks[victim].LastUse) ) victim = i;
+	}
+	return victim;
+}
+
+// Urgent chunks go to the front of the queue (moving them there if already queued), the
+// others to the back.  Returns false if the chunk is cached, queued already or past the end
+// of the image.
+bool IsoSectorCache::Queue( u32 index, bool urgent )
+{
+	if( (index << ChunkShift) >= m_iso.GetBlockCount() ) return false;
+	if( FindChunk( index ) >= 0 ) return false;
+
+	for( std::deque<u32>::iterator it( m_queue.begin() ); it != m_queue.end(); ++it )
+	{
+		if( *it != index ) continue;
+		if( !urgent || (it == m_queue.begin()) ) return false;
+
+		m_queue.erase( it );
+		break;
+	}
+
+	if( urgent )
+		m_queue.push_front( index );
+	else
+		m_queue.push_back( index );
+	return true;
+}
+
+void IsoSectorCache::Prefetch( uint lsn, uint count )
+{
+	if( lsn >= m_iso.GetBlockCount() ) return;
+
+	const u32 first = lsn >> ChunkShift;
+	u32 last = first + ReadAhead;
+	if( count && (((lsn + count - 1) >> ChunkShift) < last) ) last = (lsn + count - 1) >> ChunkShift;
+
+	ScopedLock lock( m_lock );
+
+	// Whatever was queued for the previous position is of no use after a real seek.
+	if( lsn != m_lastLsn + 1 ) m_queue.clear();
+
+	bool queued = false;
+	for( u32 index=first; index<=last; ++index )
+		queued |= Queue( index, false );
+
+	if( queued ) m_sem_event.Post();
+}
+
+int IsoSectorCache::Read( u8* dest, uint lsn, uint mode )
+{
+	if( lsn >= m_iso.GetBlockCount() ) return -1;
+
+	const u32 index = lsn >> ChunkShift;
+	u64 stallStart = 0;
+
+	ScopedLock lock( m_lock );
+	++m_stats.Requests;
+
+	int slot;
+	while( true )
+	{
+		slot = FindChunk( index );
+		if( (slot >= 0) && (m_chunks[slot].State == Chunk_Ready) ) break;
+
+		if( (slot < 0) && Queue( index, true ) ) m_sem_event.Post();
+
+		if( !stallStart )
+		{
+			stallStart = GetCPUTicks();
+			++m_stats.Stalls;
+		}
+
+		lock.Release();
+		m_sem_loaded.WaitWithoutYield();
+		lock.Acquire();
+	}
+
+	if( stallStart )
+		m_stats.StallTicks += GetCPUTicks() - stallStart;
+	else
+		++m_stats.Hits;
+
+	Chunk& chunk( m_chunks[slot] );
+	chunk.LastUse = ++m_useCount;
+	m_lastChunk = slot;
+
+	const uint sector = lsn & (ChunkSectors-1);
+	if( !(chunk.Valid & (1ULL << sector)) ) return -1;
+
+	m_iso.CopyBlock( dest, chunk.Data + sector * m_iso.GetBlockSize(), lsn, mode );
+
+	// Sequential reads keep the read-ahead window moving along.
+	if( lsn == m_lastLsn + 1 )
+	{
+		bool queued = false;
+		for( u32 i=1; i<=ReadAhead; ++i )
+			queued |= Queue( index + i, false );
+
+		if( queued ) m_sem_event.Post();
+	}
+	m_lastLsn = lsn;
+
+	return 0;
+}
+
+bool IsoSectorCache::LoadNextChunk()
+{
+	int slot;
+	u32 index;
+	{
+		ScopedLock lock( m_lock );
+		if( m_queue.empty() ) return false;
+
+		index = m_queue.front();
+		m_queue.pop_front();
+
+		if( FindChunk( index ) >= 0 ) return true;
+
+		slot = AllocChunk();
+		m_chunks[slot].Index = index;
+		m_chunks[slot].State = Chunk_Loading;
+		m_chunks[slot].Valid = 0;
+	}
+
+	Chunk& chunk( m_chunks[slot] );
+	const uint lsn = index << ChunkShift;
+	const uint remaining = m_iso.GetBlockCount() - lsn;
+	const uint count = (remaining < ChunkSectors) ? remaining : ChunkSectors;
+	const uint blocksize = m_iso.GetBlockSize();
+
+	u64 valid = (count == ChunkSectors) ? ~0ULL : ((1ULL << count) - 1);
+	bool retried = false;
+
+	const u64 start = GetCPUTicks();
+	{
+		ScopedLock io( m_io_lock );
+		if( m_iso.ReadBlocks( chunk.Data, lsn, count ) < 0 )
+		{
+			// Blockdumps only hold the sectors that were read when dumping, and damaged
+			// images may fail part way; keep whatever sectors can be read.
+			retried = true;
+			valid = 0;
+			for( uint i=0; i<count; ++i )
+			{
+				if( m_iso.ReadBlocks( chunk.Data + i * blocksize, lsn + i, 1 ) >= 0 )
+					valid |= 1ULL << i;
+			}
+		}
+	}
+	const u64 ticks = GetCPUTicks() - start;
+
+	{
+		ScopedLock lock( m_lock );
+		chunk.Valid		= valid;
+		chunk.State		= Chunk_Ready;
+		chunk.LastUse	= ++m_useCount;
+
+		++m_stats.HostReads;
+		if( retried ) ++m_stats.HostErrors;
+		m_stats.RecordLatency( ticks );
+	}
+
+	m_sem_loaded.Post();
+	return true;
+}
+
+void IsoSectorCache::ExecuteTaskInThread()
+{
+	while( !m_quit )
+	{
+		m_sem_event.WaitWithoutYield();
+		while( !m_quit && LoadNextChunk() ) {}
+	}
+}
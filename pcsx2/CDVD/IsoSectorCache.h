@@ -0,0 +1,130 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2014  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "IsoFileFormats.h"
+#include "System/SysThreads.h"
+
+#include <deque>
+
+// --------------------------------------------------------------------------------------
+//  IsoSectorCacheStats
+// --------------------------------------------------------------------------------------
+struct IsoSectorCacheStats
+{
+	// Host read latencies are kept as a histogram: bucket 0 counts reads under 64us, and
+	// each following bucket doubles that.  The last bucket counts everything slower.
+	static const int LatencyBuckets = 12;
+
+	u32		Requests;			// sectors handed to the CDVD
+	u32		Hits;				// ... that were already cached when asked for
+	u32		Stalls;				// ... that the emulation thread had to wait for
+	u64		StallTicks;			// total time spent waiting, in GetCPUTicks() units
+
+	u32		HostReads;			// chunks read from the image
+	u32		HostErrors;			// ... that had to be read again a sector at a time
+	u32		Latency[LatencyBuckets];
+
+	void Reset() { memzero( *this ); }
+	void RecordLatency( u64 ticks );
+	u32 GetLatencyPercentile( uint percent ) const;
+	u32 GetHitPercent() const;
+	void Log() const;
+};
+
+// Copies the stats of the running cache, if there is one (prefetching may be disabled, or no
+// image open).  Safe to poll from any thread while the VM runs.
+extern bool ISOgetCacheStats( IsoSectorCacheStats& dest );
+
+// --------------------------------------------------------------------------------------
+//  IsoSectorCache
+// --------------------------------------------------------------------------------------
+// Sits between the CDVD and the image of the Iso source.  Sectors are read from the image
+// a chunk at a time by a worker thread, ahead of the emulated drive: chunks are queued by
+// seek and read commands (which know the target sector long before the emulated seek
+// completes) and by sequential read-ahead after each sector handed out.  Blocks are kept
+// the way they are stored in the image and formatted for the read mode on the way out.
+//
+// The emulation thread only blocks when it asks for a sector that hasn't arrived yet; the
+// time spent doing so is recorded in the stats, along with the host read latencies.
+//
+class IsoSectorCache : public pxThread
+{
+	typedef pxThread _parent;
+
+public:
+	static const uint ChunkShift	= 6;
+	static const uint ChunkSectors	= 1 << ChunkShift;
+	static const uint NumChunks		= 64;		// 4096 sectors; about 10mb for raw images
+	static const uint ReadAhead		= 4;		// chunks queued past the one being read
+
+protected:
+	enum ChunkState
+	{
+		Chunk_Empty = 0,
+		Chunk_Loading,
+		Chunk_Ready,
+	};
+
+	struct Chunk
+	{
+		u32			Index;			// chunk number in the image (lsn >> ChunkShift)
+		ChunkState	State;
+		u32			LastUse;
+		u64			Valid;			// one bit per sector that was read successfully
+		u8*			Data;
+	};
+
+	InputIsoFile&		m_iso;
+	ScopedArray<u8>		m_buffer;
+	Chunk				m_chunks[NumChunks];
+	uint				m_lastChunk;		// slot of the last hit, checked first
+	u32					m_useCount;
+	u32					m_lastLsn;			// last sector handed out, to spot sequential reads
+
+	std::deque<u32>		m_queue;			// chunk numbers waiting to be read, most urgent first
+	Mutex				m_lock;				// protects all of the above, and the stats
+	Mutex				m_io_lock;			// held during image reads
+	Semaphore			m_sem_loaded;		// posted whenever a chunk finishes loading
+
+	volatile bool		m_quit;
+
+	IsoSectorCacheStats	m_stats;
+
+public:
+	IsoSectorCache( InputIsoFile& iso );
+	virtual ~IsoSectorCache() throw();
+
+	void Stop();
+
+	// Queues the chunks covering a seek or read target, up to ReadAhead chunks past the first.
+	// A count of zero means the size of the read isn't known (plain seeks).
+	void Prefetch( uint lsn, uint count );
+	int Read( u8* dest, uint lsn, uint mode );
+
+	// Anything else reading from the image while the cache is running must hold this.
+	Mutex& GetIoLock() { return m_io_lock; }
+
+	IsoSectorCacheStats GetStats();
+
+protected:
+	void ExecuteTaskInThread();
+	bool LoadNextChunk();
+
+	int FindChunk( u32 index ) const;
+	int AllocChunk();
+	bool Queue( u32 index, bool urgent );
+};
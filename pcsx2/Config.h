@@ -435,6 +435,8 @@ struct Pcsx2Config
 		bool
 			CdvdVerboseReads	:1,		// enables cdvd read activity verbosely dumped to the console
 			CdvdDumpBlocks		:1,		// enables cdvd block dumping
+			CdvdPrefetch		:1,		// reads iso sectors ahead of the emulated drive on a worker thread
+			CdvdMapImages		:1,		// reads flat iso images through memory-mapped views (local images on fast storage)
 			EnablePatches		:1,		// enables patch detection and application
 			EnableCheats		:1,		// enables cheat detection and application
 			EnableWideScreenPatches		:1,
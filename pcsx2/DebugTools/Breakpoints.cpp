@@ -18,6 +18,7 @@
 #include "SymbolMap.h"
 #include "MIPSAnalyst.h"
 #include <cstdio>
+#include <algorithm>
 #include "../R5900.h"
 #include "../System.h"
 
@@ -27,6 +28,9 @@ u64 CBreakPoints::breakSkipFirstTicks_ = 0;
 std::vector<MemCheck> CBreakPoints::memChecks_;
 std::vector<MemCheck *> CBreakPoints::cleanupMemChecks_;
 bool CBreakPoints::breakpointTriggered_ = false;
+std::vector<u32> CBreakPoints::breakAddrs_;
+std::vector<MemCheckRange> CBreakPoints::memCheckReads_;
+std::vector<MemCheckRange> CBreakPoints::memCheckWrites_;
 
 // called from the dynarec
 u32 __fastcall standardizeBreakpointAddress(u32 addr)
@@ -145,8 +149,10 @@ size_t CBreakPoints::FindMemCheck(u32 start, u32 end)
 
 bool CBreakPoints::IsAddressBreakPoint(u32 addr)
 {
-	size_t bp = FindBreakpoint(addr);
-	return bp != INVALID_BREAKPOINT && breakPoints_[bp].enabled;
+	if (breakAddrs_.empty())
+		return false;
+
+	return std::binary_search(breakAddrs_.begin(), breakAddrs_.end(), standardizeBreakpointAddress(addr));
 }
 
 bool CBreakPoints::IsAddressBreakPoint(u32 addr, bool* enabled)
@@ -228,8 +234,9 @@ void CBreakPoints::ClearTemporaryBreakPoints()
 	{
 		if (breakPoints_[i].temporary)
 		{
-			Update(breakPoints_[i].addr);
+			u32 addr = breakPoints_[i].addr;
 			breakPoints_.erase(breakPoints_.begin() + i);
+			Update(addr);
 		}
 	}
 }
@@ -365,6 +372,90 @@ const std::vector<BreakPoint> CBreakPoints::GetBreakpoints()
 	return breakPoints_;
 }
 
+static bool CompareRangeEnd(u32 addr, const MemCheckRange& range)
+{
+	return addr < range.end;
+}
+
+bool CBreakPoints::HasMemChecks(bool write)
+{
+	return !(write ? memCheckWrites_ : memCheckReads_).empty();
+}
+
+// Returns the combined MemCheckResult of all memchecks overlapping [start, end), for
+// standardized addresses.
+u32 CBreakPoints::GetMemCheckResult(u32 start, u32 end, bool write)
+{
+	const std::vector<MemCheckRange>& ranges = write ? memCheckWrites_ : memCheckReads_;
+
+	// first range ending after the start of the access
+	auto it = std::upper_bound(ranges.begin(), ranges.end(), start, CompareRangeEnd);
+
+	u32 result = 0;
+	for (; it != ranges.end() && it->start < end; ++it)
+		result |= it->result;
+
+	return result;
+}
+
+// Flattens the memchecks matching condMask into sorted, non-overlapping spans.  Spans are
+// split wherever a memcheck starts or ends, so each one maps to a single result.
+void CBreakPoints::BuildMemCheckRanges(std::vector<MemCheckRange>& dest, int condMask)
+{
+	dest.clear();
+
+	std::vector<u32> bounds;
+	for (size_t i = 0; i < memChecks_.size(); ++i)
+	{
+		bounds.push_back(standardizeBreakpointAddress(memChecks_[i].start));
+		bounds.push_back(standardizeBreakpointAddress(memChecks_[i].end));
+	}
+
+	std::sort(bounds.begin(), bounds.end());
+	bounds.erase(std::unique(bounds.begin(), bounds.end()), bounds.end());
+
+	for (size_t b = 1; b < bounds.size(); ++b)
+	{
+		MemCheckRange range;
+		range.start = bounds[b-1];
+		range.end = bounds[b];
+		range.result = 0;
+
+		for (size_t i = 0; i < memChecks_.size(); ++i)
+		{
+			const MemCheck& check = memChecks_[i];
+			if ((check.cond & condMask) == 0)
+				continue;
+
+			if (standardizeBreakpointAddress(check.start) <= range.start && range.end <= standardizeBreakpointAddress(check.end))
+				range.result |= check.result;
+		}
+
+		if (range.result == 0)
+			continue;
+
+		if (!dest.empty() && dest.back().end == range.start && dest.back().result == range.result)
+			dest.back().end = range.end;
+		else
+			dest.push_back(range);
+	}
+}
+
+void CBreakPoints::UpdateLookups()
+{
+	breakAddrs_.clear();
+	for (size_t i = 0; i < breakPoints_.size(); ++i)
+	{
+		// Same rules as FindBreakpoint: the first breakpoint at an address decides.
+		if (breakPoints_[i].enabled && FindBreakpoint(breakPoints_[i].addr) == i)
+			breakAddrs_.push_back(standardizeBreakpointAddress(breakPoints_[i].addr));
+	}
+	std::sort(breakAddrs_.begin(), breakAddrs_.end());
+
+	BuildMemCheckRanges(memCheckReads_, MEMCHECK_READ);
+	BuildMemCheckRanges(memCheckWrites_, MEMCHECK_WRITE);
+}
+
 // including them earlier causes some ambiguities
 #include "App.h"
 #include "Debugger/DisassemblyDialog.h"
@@ -377,6 +468,8 @@ void CBreakPoints::Update(u32 addr)
 		r5900Debug.pauseCpu();
 		resume = true;
 	}
+
+	UpdateLookups();
 	
 //	if (addr != 0)
 //		Cpu->Clear(addr-4,8);
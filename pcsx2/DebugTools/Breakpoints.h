@@ -104,6 +104,15 @@ struct MemCheck
 	}
 };
 
+// One span of memory covered by memchecks, as used by the recompiler.  Spans are sorted and
+// don't overlap; result holds the combined actions of every memcheck covering it.
+struct MemCheckRange
+{
+	u32 start;
+	u32 end;
+	u32 result;
+};
+
 // BreakPoints cannot overlap, only one is allowed per address.
 // MemChecks can overlap, as long as their ends are different.
 // WARNING: MemChecks are not used in the interpreter or HLE currently.
@@ -141,6 +150,11 @@ public:
 	static const std::vector<MemCheck> GetMemChecks();
 	static const std::vector<BreakPoint> GetBreakpoints();
 
+	// Fast lookups for the recompiler, which asks for every instruction it compiles.  They
+	// work on tables built by Update(), and don't copy anything.
+	static bool HasMemChecks(bool write);
+	static u32 GetMemCheckResult(u32 start, u32 end, bool write);
+
 	static void Update(u32 addr = 0);
 
 	static void SetBreakpointTriggered(bool b) { breakpointTriggered_ = b; };
@@ -151,6 +165,9 @@ private:
 	// Finds exactly, not using a range check.
 	static size_t FindMemCheck(u32 start, u32 end);
 
+	static void UpdateLookups();
+	static void BuildMemCheckRanges(std::vector<MemCheckRange>& dest, int condMask);
+
 	static std::vector<BreakPoint> breakPoints_;
 	static u32 breakSkipFirstAt_;
 	static u64 breakSkipFirstTicks_;
@@ -158,6 +175,11 @@ private:
 
 	static std::vector<MemCheck> memChecks_;
 	static std::vector<MemCheck *> cleanupMemChecks_;
+
+	// Standardized addresses of enabled breakpoints, sorted.
+	static std::vector<u32> breakAddrs_;
+	static std::vector<MemCheckRange> memCheckReads_;
+	static std::vector<MemCheckRange> memCheckWrites_;
 };
 
 
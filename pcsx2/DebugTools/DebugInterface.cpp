@@ -256,6 +256,9 @@ void R5900DebugInterface::write8(u32 address, u8 value)
 	if (!isValidAddress(address))
 		return;
 
+	// Main memory is write protected while the snapshots track its dirty pages, and this
+	// isn't the core thread (the memory view pauses the cpu before writing).
+	mmap_StopDirtyRamPages();
 	memWrite8(address,value);
 }
 
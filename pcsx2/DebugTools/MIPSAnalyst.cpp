@@ -20,8 +20,10 @@
 #include "SymbolMap.h"
 #include "DebugInterface.h"
 #include "../R5900.h"
+#include "../Elfheader.h"
+#include "Utilities/PersistentThread.h"
 
-static std::vector<MIPSAnalyst::AnalyzedFunction> functions;
+static void NotifyDebugger();
 
 #define MIPS_MAKE_J(addr)   (0x08000000 | ((addr)>>2))
 #define MIPS_MAKE_JAL(addr) (0x0C000000 | ((addr)>>2))
@@ -36,7 +38,9 @@ namespace MIPSAnalyst
 		return buffer;
 	}
 
-	void ScanForFunctions(u32 startAddr, u32 endAddr, bool insertSymbols) {
+	// Splits [startAddr, endAddr] into functions.  Functions already in the symbol map are
+	// listed as they are.
+	static void FindFunctions(u32 startAddr, u32 endAddr, std::vector<AnalyzedFunction>& functions) {
 		AnalyzedFunction currentFunction = {startAddr};
 
 		u32 furthestBranch = 0;
@@ -151,16 +155,272 @@ namespace MIPSAnalyst
 		currentFunction.end = addr + 4;
 		functions.push_back(currentFunction);
 
-		for (auto iter = functions.begin(); iter != functions.end(); iter++) {
+		for (auto iter = functions.begin(); iter != functions.end(); iter++)
 			iter->size = iter->end - iter->start + 4;
-			if (insertSymbols) {
+	}
+
+	void ScanForFunctions(u32 startAddr, u32 endAddr, bool insertSymbols) {
+		std::vector<AnalyzedFunction> functions;
+		FindFunctions(startAddr, endAddr, functions);
+
+		if (insertSymbols) {
+			for (auto iter = functions.begin(); iter != functions.end(); iter++) {
 				char temp[256];
-				symbolMap.AddFunction(DefaultFunctionName(temp, iter->start), iter->start, iter->end - iter->start + 4);
+				symbolMap.AddFunction(DefaultFunctionName(temp, iter->start), iter->start, iter->size);
 			}
 		}
 	}
 
 
+	// --------------------------------------------------------------------------------------
+	//  AnalysisThread
+	// --------------------------------------------------------------------------------------
+	// Runs ScanForFunctions over the ELF's code in the background, so that opening the
+	// debugger doesn't stall the UI, and rescans whatever the recompiler reports as changed.
+	// Only functions created by the scan (the z_un_ ones) are ever replaced; anything loaded
+	// or named by the user is left alone.
+	//
+	// The analysis only runs while the debugger is showing.  Meanwhile the code changes are
+	// just summed up into one range, which gets rescanned when the debugger is shown again.
+
+	class AnalysisThread : public pxThread
+	{
+		typedef pxThread _parent;
+
+	protected:
+		Threading::Mutex						m_lock;
+		std::vector< std::pair<u32, u32> >		m_pending;		// start/end address pairs
+		u32										m_regionStart;
+		u32										m_regionEnd;
+		u32										m_staleStart;	// changed while paused
+		u32										m_staleEnd;
+		bool									m_rescanAll;
+
+	public:
+		AnalysisThread()
+			: _parent( L"Debugger Analysis" )
+		{
+			m_regionStart = m_regionEnd = 0;
+			m_staleStart = m_staleEnd = 0;
+			m_rescanAll = true;
+		}
+
+		virtual ~AnalysisThread() throw()
+		{
+			_parent::Cancel();
+		}
+
+		// Scans everything again the next time the analysis is resumed (a new ELF was loaded).
+		void RescanAll()
+		{
+			Threading::ScopedLock lock(m_lock);
+			m_rescanAll = true;
+			m_pending.clear();
+			m_staleStart = m_staleEnd = 0;
+		}
+
+		// Queues whatever changed since the analysis was paused, or the whole region if it's
+		// one that hasn't been scanned yet.
+		void Resume(u32 start, u32 end)
+		{
+			{
+				Threading::ScopedLock lock(m_lock);
+
+				if (m_rescanAll || start != m_regionStart || end != m_regionEnd)
+				{
+					m_regionStart = start;
+					m_regionEnd = end;
+					m_rescanAll = false;
+					m_pending.clear();
+					m_pending.push_back(std::make_pair(start, end));
+				}
+				else if (m_staleStart < m_staleEnd)
+					m_pending.push_back(std::make_pair(m_staleStart, m_staleEnd));
+
+				m_staleStart = m_staleEnd = 0;
+				if (m_pending.empty()) return;
+			}
+			m_sem_event.Post();
+		}
+
+		void Pause()
+		{
+			Threading::ScopedLock lock(m_lock);
+
+			for (size_t i = 0; i < m_pending.size(); ++i)
+				AddStale(m_pending[i].first, m_pending[i].second);
+			m_pending.clear();
+		}
+
+		void Queue(u32 start, u32 end)
+		{
+			{
+				Threading::ScopedLock lock(m_lock);
+
+				start = std::max(start, m_regionStart);
+				end = std::min(end, m_regionEnd);
+				if (start >= end) return;
+
+				if (!AnalysisActive)
+				{
+					AddStale(start & ~3, end);
+					return;
+				}
+
+				m_pending.push_back(std::make_pair(start & ~3, end));
+			}
+			m_sem_event.Post();
+		}
+
+	protected:
+		// m_lock must be held.
+		void AddStale(u32 start, u32 end)
+		{
+			if (m_staleStart >= m_staleEnd)
+			{
+				m_staleStart = start;
+				m_staleEnd = end;
+			}
+			else
+			{
+				m_staleStart = std::min(m_staleStart, start);
+				m_staleEnd = std::max(m_staleEnd, end);
+			}
+		}
+
+		void ExecuteTaskInThread()
+		{
+			while (true)
+			{
+				m_sem_event.WaitWithoutYield();
+				TestCancel();
+
+				std::vector< std::pair<u32, u32> > ranges;
+				{
+					Threading::ScopedLock lock(m_lock);
+					ranges.swap(m_pending);
+				}
+
+				if (ranges.empty()) continue;
+
+				// Merge overlapping and adjacent ranges, so that a burst of small clears
+				// rescans each function only once.
+				std::sort(ranges.begin(), ranges.end());
+
+				size_t count = 0;
+				for (size_t i = 1; i < ranges.size(); ++i)
+				{
+					if (ranges[i].first <= ranges[count].second)
+						ranges[count].second = std::max(ranges[count].second, ranges[i].second);
+					else
+						ranges[++count] = ranges[i];
+				}
+				ranges.resize(count + 1);
+
+				size_t done = 0;
+				for (; done < ranges.size() && AnalysisActive; ++done)
+					Rescan(ranges[done].first, ranges[done].second);
+
+				if (done < ranges.size())
+				{
+					// Paused halfway: keep the rest for later.
+					for (size_t i = done; i < ranges.size(); ++i)
+						Queue(ranges[i].first, ranges[i].second);
+				}
+
+				if (done > 0 && AnalysisActive)
+					NotifyDebugger();
+			}
+		}
+
+		static bool IsGeneratedFunction(u32 address)
+		{
+			return symbolMap.GetLabelString(address).compare(0, 5, "z_un_") == 0;
+		}
+
+		// Replaces the generated functions of the range in one go, so that only the symbols
+		// of the range are touched.
+		void Rescan(u32 start, u32 end)
+		{
+			// Widen the range to the generated functions it cuts into.
+			u32 func = symbolMap.GetFunctionStart(start);
+			if (func != SymbolMap::INVALID_ADDRESS && IsGeneratedFunction(func))
+				start = func;
+
+			func = symbolMap.GetFunctionStart(end - 4);
+			if (func != SymbolMap::INVALID_ADDRESS && IsGeneratedFunction(func))
+				end = func + symbolMap.GetFunctionSize(func);
+
+			symbolMap.RemoveFunctions(start, end, "z_un_");
+
+			std::vector<AnalyzedFunction> found;
+			FindFunctions(start, end - 4, found);
+
+			std::vector<SymbolEntry> added(found.size());
+			for (size_t i = 0; i < found.size(); ++i)
+			{
+				char temp[256];
+				added[i].name = DefaultFunctionName(temp, found[i].start);
+				added[i].address = found[i].start;
+				added[i].size = found[i].size;
+			}
+
+			symbolMap.AddFunctions(added);
+		}
+	};
+
+	// The thread is started on first use and then just idles when the analysis is paused;
+	// pausing a scan halfway is done through AnalysisActive instead of cancelling it.
+	static ScopedPtr<AnalysisThread> s_analysis;
+	static volatile bool s_analysisShown = false;
+	volatile bool AnalysisActive = false;
+	volatile bool AnalysisTracking = false;
+
+	void StartAnalysis()
+	{
+		s_analysisShown = true;
+
+		if (!s_analysis)
+		{
+			s_analysis = new AnalysisThread();
+			s_analysis->Start();
+		}
+
+		const u32 start = ElfTextRange.first;
+		const u32 end = ElfTextRange.first + ElfTextRange.second;
+
+		AnalysisActive = start < end;
+		if (!AnalysisActive) return;
+
+		AnalysisTracking = true;
+		s_analysis->Resume(start, end);
+	}
+
+	void StopAnalysis()
+	{
+		s_analysisShown = false;
+		AnalysisActive = false;
+		if (s_analysis)
+			s_analysis->Pause();
+	}
+
+	void RestartAnalysis()
+	{
+		// Never started: the first StartAnalysis scans everything anyway.
+		if (!s_analysis) return;
+
+		AnalysisTracking = false;
+		s_analysis->RescanAll();
+		if (s_analysisShown)
+			StartAnalysis();
+	}
+
+	void QueueAnalysis(u32 start, u32 size)
+	{
+		if (s_analysis)
+			s_analysis->Queue(start, start + size);
+	}
+
 	enum BranchType { NONE, JUMP, BRANCH };
 	struct BranchInfo
 	{
@@ -454,3 +714,11 @@ namespace MIPSAnalyst
 		return info;
 	}
 }
+
+// including them earlier causes some ambiguities
+#include "App.h"
+
+static void NotifyDebugger()
+{
+	sApp.PostAppMethod(&Pcsx2App::resetDebugger);
+}
@@ -41,6 +41,17 @@ namespace MIPSAnalyst
 
 	void ScanForFunctions(u32 startAddr, u32 endAddr, bool insertSymbols);
 
+	// Background analysis of the running ELF's code, kept up to date with the recompiler's
+	// code invalidations.  It runs while the debugger is showing (StartAnalysis/StopAnalysis);
+	// RestartAnalysis has a new ELF scanned from scratch.  QueueAnalysis is cheap enough to
+	// call from recClear, but is only needed while AnalysisTracking is set.
+	extern volatile bool AnalysisActive;
+	extern volatile bool AnalysisTracking;
+	void StartAnalysis();
+	void StopAnalysis();
+	void RestartAnalysis();
+	void QueueAnalysis(u32 start, u32 size);
+
 	enum LoadStoreLRType { LOADSTORE_NORMAL, LOADSTORE_LEFT, LOADSTORE_RIGHT };
 
 	typedef struct {
@@ -446,30 +446,34 @@ void SymbolMap::UpdateActiveSymbols() {
 	for (auto it = functions.begin(), end = functions.end(); it != end; ++it) {
 		const auto mod = activeModuleIndexes.find(it->second.module);
 		if (it->second.module <= 0) {
-			activeFunctions.insert(std::make_pair(it->second.start, it->second));
+			activeFunctions.append(std::make_pair(it->second.start, it->second));
 		} else if (mod != activeModuleIndexes.end()) {
-			activeFunctions.insert(std::make_pair(mod->second + it->second.start, it->second));
+			activeFunctions.append(std::make_pair(mod->second + it->second.start, it->second));
 		}
 	}
 
 	for (auto it = labels.begin(), end = labels.end(); it != end; ++it) {
 		const auto mod = activeModuleIndexes.find(it->second.module);
 		if (it->second.module <= 0) {
-			activeLabels.insert(std::make_pair(it->second.addr, it->second));
+			activeLabels.append(std::make_pair(it->second.addr, it->second));
 		} else if (mod != activeModuleIndexes.end()) {
-			activeLabels.insert(std::make_pair(mod->second + it->second.addr, it->second));
+			activeLabels.append(std::make_pair(mod->second + it->second.addr, it->second));
 		}
 	}
 
 	for (auto it = data.begin(), end = data.end(); it != end; ++it) {
 		const auto mod = activeModuleIndexes.find(it->second.module);
 		if (it->second.module <= 0) {
-			activeData.insert(std::make_pair(it->second.start, it->second));
+			activeData.append(std::make_pair(it->second.start, it->second));
 		} else if (mod != activeModuleIndexes.end()) {
-			activeData.insert(std::make_pair(mod->second + it->second.start, it->second));
+			activeData.append(std::make_pair(mod->second + it->second.start, it->second));
 		}
 	}
 
+	activeFunctions.Rebuild();
+	activeLabels.Rebuild();
+	activeData.Rebuild();
+
 	AssignFunctionIndices();
 }
 
@@ -519,6 +523,87 @@ bool SymbolMap::RemoveFunction(u32 startAddress, bool removeName) {
 	return true;
 }
 
+// Picks the entries whose address is in a sorted list.
+struct AddressListed {
+	const std::vector<u32>& list;
+	AddressListed(const std::vector<u32>& addresses) : list(addresses) {}
+
+	template< typename T >
+	bool operator()(const std::pair<u32, T>& item) const {
+		return std::binary_search(list.begin(), list.end(), item.first);
+	}
+};
+
+// Removes the functions starting within [start, end) whose names begin with namePrefix,
+// along with their names.
+void SymbolMap::RemoveFunctions(u32 start, u32 end, const char* namePrefix) {
+	Threading::ScopedLock guard(lock_);
+	const size_t prefixLength = strlen(namePrefix);
+
+	std::vector<u32> removed;
+	for (auto it = activeFunctions.lower_bound(start), last = activeFunctions.lower_bound(end); it != last; ++it) {
+		auto labelIt = activeLabels.find(it->first);
+		if (labelIt == activeLabels.end() || strncmp(labelIt->second.name, namePrefix, prefixLength) != 0)
+			continue;
+
+		functions.erase(std::make_pair(it->second.module, it->second.start));
+		labels.erase(std::make_pair(labelIt->second.module, labelIt->second.addr));
+		removed.push_back(it->first);
+	}
+
+	if (removed.empty())
+		return;
+
+	activeFunctions.erase_if(activeFunctions.lower_bound(start), activeFunctions.lower_bound(end), AddressListed(removed));
+	activeLabels.erase_if(activeLabels.lower_bound(start), activeLabels.lower_bound(end), AddressListed(removed));
+}
+
+// Adds functions along with their names.  Functions that are already known are left alone.
+void SymbolMap::AddFunctions(const std::vector<SymbolEntry>& funcs) {
+	Threading::ScopedLock guard(lock_);
+
+	std::vector<AddressMap<FunctionEntry>::value_type> addedFunctions;
+	std::vector<AddressMap<LabelEntry>::value_type> addedLabels;
+
+	for (auto it = funcs.begin(), end = funcs.end(); it != end; ++it) {
+		const int moduleIndex = GetModuleIndex(it->address);
+		const u32 relAddress = GetModuleRelativeAddr(it->address, moduleIndex);
+		const auto symbolKey = std::make_pair(moduleIndex, relAddress);
+		const auto fallbackKey = std::make_pair(0, it->address);
+
+		if (functions.find(symbolKey) != functions.end() || functions.find(fallbackKey) != functions.end())
+			continue;
+
+		// Same as UpdateActiveSymbols: symbols outside of any module are always active.
+		const bool active = moduleIndex <= 0 || IsModuleActive(moduleIndex);
+
+		FunctionEntry func;
+		func.start = relAddress;
+		func.size = it->size;
+		func.index = (int)functions.size();
+		func.module = moduleIndex;
+		functions[symbolKey] = func;
+
+		if (active)
+			addedFunctions.push_back(std::make_pair(it->address, func));
+
+		if (labels.find(symbolKey) == labels.end() && labels.find(fallbackKey) == labels.end()) {
+			LabelEntry label;
+			label.addr = relAddress;
+			label.module = moduleIndex;
+			strncpy(label.name, it->name.c_str(), 128);
+			label.name[127] = 0;
+			labels[symbolKey] = label;
+
+			if (active)
+				addedLabels.push_back(std::make_pair(it->address, label));
+		}
+	}
+
+	activeFunctions.merge(addedFunctions);
+	activeLabels.merge(addedLabels);
+}
+
 void SymbolMap::AddLabel(const char* name, u32 address, int moduleIndex) {
 	Threading::ScopedLock guard(lock_);
 
@@ -19,6 +19,7 @@
 #include <set>
 #include <map>
 #include <string>
+#include <algorithm>
 
 #include "Utilities/Threading.h"
 #include "Pcsx2Types.h"
@@ -53,6 +54,124 @@ enum DataType {
 	DATATYPE_NONE, DATATYPE_BYTE, DATATYPE_HALFWORD, DATATYPE_WORD, DATATYPE_ASCII
 };
 
+// Sorted flat array keyed by address, standing in for a std::map: lookups are binary
+// searches over contiguous memory.  Inserting in address order (which is what function
+// scans produce) only appends; Rebuild sorts a batch of appended entries at once.
+template< typename T >
+class AddressMap
+{
+public:
+	typedef std::pair<u32, T> value_type;
+	typedef typename std::vector<value_type>::iterator iterator;
+	typedef typename std::vector<value_type>::const_iterator const_iterator;
+	typedef typename std::vector<value_type>::const_reverse_iterator const_reverse_iterator;
+
+	iterator begin()						{ return m_items.begin(); }
+	iterator end()							{ return m_items.end(); }
+	const_iterator begin() const			{ return m_items.begin(); }
+	const_iterator end() const				{ return m_items.end(); }
+	const_reverse_iterator rbegin() const	{ return m_items.rbegin(); }
+	const_reverse_iterator rend() const		{ return m_items.rend(); }
+
+	bool empty() const	{ return m_items.empty(); }
+	size_t size() const	{ return m_items.size(); }
+	void clear()		{ m_items.clear(); }
+
+	iterator upper_bound(u32 addr)
+	{
+		return std::upper_bound(m_items.begin(), m_items.end(), addr, CompareKey());
+	}
+
+	const_iterator upper_bound(u32 addr) const
+	{
+		return std::upper_bound(m_items.begin(), m_items.end(), addr, CompareKey());
+	}
+
+	iterator lower_bound(u32 addr)
+	{
+		return std::lower_bound(m_items.begin(), m_items.end(), addr, CompareKey());
+	}
+
+	iterator find(u32 addr)
+	{
+		iterator it = std::lower_bound(m_items.begin(), m_items.end(), addr, CompareKey());
+		return (it != m_items.end() && it->first == addr) ? it : m_items.end();
+	}
+
+	const_iterator find(u32 addr) const
+	{
+		const_iterator it = std::lower_bound(m_items.begin(), m_items.end(), addr, CompareKey());
+		return (it != m_items.end() && it->first == addr) ? it : m_items.end();
+	}
+
+	// Like std::map::insert, an existing entry is left alone.
+	void insert(const value_type& item)
+	{
+		if (m_items.empty() || m_items.back().first < item.first)
+		{
+			m_items.push_back(item);
+			return;
+		}
+
+		iterator it = std::lower_bound(m_items.begin(), m_items.end(), item.first, CompareKey());
+		if (it == m_items.end() || it->first != item.first)
+			m_items.insert(it, item);
+	}
+
+	void erase(iterator it)
+	{
+		m_items.erase(it);
+	}
+
+	// Removes the entries of [first, last) that pred picks, in one pass.
+	template< typename Pred >
+	void erase_if(iterator first, iterator last, Pred pred)
+	{
+		m_items.erase(std::remove_if(first, last, pred), last);
+	}
+
+	// Inserts a batch of entries in one pass.  Like insert, existing entries are left alone.
+	void merge(std::vector<value_type>& items)
+	{
+		if (items.empty()) return;
+
+		std::stable_sort(items.begin(), items.end(), CompareKey());
+
+		const size_t count = m_items.size();
+		m_items.insert(m_items.end(), items.begin(), items.end());
+		std::inplace_merge(m_items.begin(), m_items.begin() + count, m_items.end(), CompareKey());
+		m_items.erase(std::unique(m_items.begin(), m_items.end(), SameKey()), m_items.end());
+	}
+
+	// Unsorted append, for building the whole map at once.  Call Rebuild() afterward.
+	void append(const value_type& item)
+	{
+		m_items.push_back(item);
+	}
+
+	// Sorts appended entries; for duplicate addresses the first one appended wins.
+	void Rebuild()
+	{
+		std::stable_sort(m_items.begin(), m_items.end(), CompareKey());
+		m_items.erase(std::unique(m_items.begin(), m_items.end(), SameKey()), m_items.end());
+	}
+
+protected:
+	struct CompareKey
+	{
+		bool operator()(const value_type& left, const value_type& right) const	{ return left.first < right.first; }
+		bool operator()(const value_type& left, u32 right) const				{ return left.first < right; }
+		bool operator()(u32 left, const value_type& right) const				{ return left < right.first; }
+	};
+
+	struct SameKey
+	{
+		bool operator()(const value_type& left, const value_type& right) const	{ return left.first == right.first; }
+	};
+
+	std::vector<value_type> m_items;
+};
+
 class SymbolMap {
 public:
 	SymbolMap() {}
@@ -82,6 +201,11 @@ public:
 	bool SetFunctionSize(u32 startAddress, u32 newSize);
 	bool RemoveFunction(u32 startAddress, bool removeName);
 
+	// Batch versions for the background analysis, which only update the active symbols of
+	// the addresses they touch.
+	void RemoveFunctions(u32 start, u32 end, const char* namePrefix);
+	void AddFunctions(const std::vector<SymbolEntry>& funcs);
+
 	void AddLabel(const char* name, u32 address, int moduleIndex = -1);
 	std::string GetLabelString(u32 address) const;
 	void SetLabelName(const char* name, u32 address, bool updateImmediately = true);
@@ -130,9 +254,9 @@ private:
 	};
 
 	// These are flattened, read-only copies of the actual data in active modules only.
-	std::map<u32, const FunctionEntry> activeFunctions;
-	std::map<u32, const LabelEntry> activeLabels;
-	std::map<u32, const DataEntry> activeData;
+	AddressMap<FunctionEntry> activeFunctions;
+	AddressMap<LabelEntry> activeLabels;
+	AddressMap<DataEntry> activeData;
 
 	// This is indexed by the end address of the module.
 	std::map<u32, const ModuleEntry> activeModuleEnds;
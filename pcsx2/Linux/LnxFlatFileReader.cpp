@@ -16,11 +16,22 @@
 #include "PrecompiledHeader.h"
 #include "AsyncFileReader.h"
 
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <errno.h>
+
 FlatFileReader::FlatFileReader(void)
 {
 	m_blocksize = 2048;
 	m_fd = 0;
 	m_aio_context = 0;
+
+	m_mapped = false;
+	m_filesize = 0;
+	m_view = NULL;
+	m_viewoffset = 0;
+	m_viewsize = 0;
+	m_viewresult = -2;
 }
 
 FlatFileReader::~FlatFileReader(void)
@@ -37,6 +48,13 @@ bool FlatFileReader::Open(const wxString& fileName)
 
     m_fd = wxOpen(fileName, O_RDONLY, 0);
 
+	struct stat st;
+	if (EmuConfig.CdvdMapImages && (m_fd > 0) && (fstat(m_fd, &st) == 0))
+	{
+		m_filesize = st.st_size;
+		m_mapped = true;
+	}
+
 	return (m_fd != 0);
 }
 
@@ -48,6 +66,13 @@ int FlatFileReader::ReadSync(void* pBuffer, uint sector, uint count)
 
 void FlatFileReader::BeginRead(void* pBuffer, uint sector, uint count)
 {
+	if (const u8* src = MapBlocks(sector, count))
+	{
+		memcpy_fast(pBuffer, src, count * m_blocksize);
+		m_viewresult = 1;
+		return;
+	}
+
 	u64 offset;
 	offset = sector * (s64)m_blocksize + m_dataoffset;
 
@@ -62,11 +87,16 @@ void FlatFileReader::BeginRead(void* pBuffer, uint sector, uint count)
 
 int FlatFileReader::FinishRead(void)
 {
-	u32 bytes;
+	if (m_viewresult != -2)
+	{
+		int ret = m_viewresult;
+		m_viewresult = -2;
+		return ret;
+	}
 
 	int min_nr = 1;
 	int max_nr = 1;
-    struct io_event* events = new io_event[max_nr];
+	struct io_event events[1];
 
 	int event = io_getevents(m_aio_context, min_nr, max_nr, events, NULL);
 	if (event < 1) {
@@ -82,10 +112,16 @@ void FlatFileReader::CancelRead(void)
 	// Note: io_cancel exists but need the iocb structure as parameter
 	// int io_cancel(aio_context_t ctx_id, struct iocb *iocb,
 	//                struct io_event *result);
+
+	// A read served from the mapped view is done already; just forget its result.
+	m_viewresult = -2;
 }
 
 void FlatFileReader::Close(void)
 {
+	UnmapView();
+	m_mapped = false;
+	m_viewresult = -2;
 
 	if (m_fd) close(m_fd);
 
@@ -99,3 +135,76 @@ uint FlatFileReader::GetBlockCount(void) const
 {
 	return (int)(Path::GetFileSize(m_filename) / m_blocksize);
 }
+
+// Returns a pointer to the given blocks, moving the view window if they're outside of it,
+// or NULL if the file isn't mapped.  If mapping fails the reader drops back to aio reads.
+const u8* FlatFileReader::MapBlocks(uint sector, uint count)
+{
+	if (!m_mapped) return NULL;
+
+	const s64 offset = sector * (s64)m_blocksize + m_dataoffset;
+	const s64 length = count * (s64)m_blocksize;
+	if ((offset < 0) || (offset + length > m_filesize)) return NULL;
+
+	if (!m_view || (offset < m_viewoffset) || (offset + length > m_viewoffset + m_viewsize))
+	{
+		// A window that follows on from the last one means the image is being streamed:
+		// let the kernel read ahead aggressively (and drop pages behind us).
+		const bool streaming = m_view && (offset >= m_viewoffset + m_viewsize) &&
+			(offset < m_viewoffset + m_viewsize + MapWindowSize);
+
+		const s64 start = offset & ~(s64)(MapAlign - 1);
+		s64 size = MapWindowSize;
+		if (size < offset + length - start) size = offset + length - start;
+		if (size > m_filesize - start) size = m_filesize - start;
+
+		UnmapView();
+
+		void* view = mmap(NULL, size, PROT_READ, MAP_SHARED, m_fd, start);
+		if (view == MAP_FAILED)
+		{
+			Console.Warning(L"isoFile: could not map '%s' (%s), using regular reads.", WX_STR(m_filename), WX_STR(fromUTF8(strerror(errno))));
+			m_mapped = false;
+			return NULL;
+		}
+
+		m_view = (u8*)view;
+		m_viewoffset = start;
+		m_viewsize = (uint)size;
+
+		madvise(m_view, m_viewsize, streaming ? MADV_SEQUENTIAL : MADV_NORMAL);
+	}
+
+	return m_view + (offset - m_viewoffset);
+}
+
+void FlatFileReader::UnmapView()
+{
+	if (m_view) munmap(m_view, m_viewsize);
+
+	m_view = NULL;
+	m_viewoffset = 0;
+	m_viewsize = 0;
+}
+
+void FlatFileReader::Prefetch(uint sector, uint count)
+{
+	if (!m_mapped) return;
+
+	s64 offset = sector * (s64)m_blocksize + m_dataoffset;
+	s64 length = count * (s64)m_blocksize;
+	if (offset >= m_filesize) return;
+	if (length > m_filesize - offset) length = m_filesize - offset;
+
+	if (m_view && (offset >= m_viewoffset) && (offset + length <= m_viewoffset + m_viewsize))
+	{
+		// madvise wants a page aligned start.
+		const s64 start = (offset - m_viewoffset) & ~(s64)(__pagesize - 1);
+		madvise(m_view + start, (offset - m_viewoffset) + length - start, MADV_WILLNEED);
+	}
+	else
+	{
+		// Not in the current window (yet); the page cache can be primed all the same.
+		posix_fadvise(m_fd, offset, length, POSIX_FADV_WILLNEED);
+	}
+}
@@ -729,6 +729,7 @@ void eeMemoryReserve::Reset()
 		mmap_faultHandler = new mmap_PageFaultHandler();
 	}
 	
+	mmap_StopDirtyRamPages();
 	_parent::Reset();
 
 	// Note!!  Ideally the vtlb should only be initialized once, and then subsequent
@@ -852,6 +853,7 @@ void eeMemoryReserve::Reset()
 
 void eeMemoryReserve::Decommit()
 {
+	mmap_StopDirtyRamPages();
 	_parent::Decommit();
 	eeMem = NULL;
 }
@@ -912,6 +914,14 @@ struct vtlb_PageProtectionInfo
 
 static __aligned16 vtlb_PageProtectionInfo m_PageProtectInfo[Ps2MemSize::MainRam >> 12];
 
+// Dirty page tracking, for the in-memory snapshots: while it's on, the pages not written to
+// since the last mmap_ResetDirtyRamPages are write protected as well.  The first write to one
+// faults and marks the page dirty; pages under ProtMode_Write then go on to the block clearing
+// as usual.  Page faults are only handled on the threads that run the VM (on Windows), so
+// anything else writing to main memory has to stop the tracking first.
+static bool m_TrackDirtyPages = false;
+static __aligned16 u8 m_DirtyPages[Ps2MemSize::MainRam >> 12];
+
 
 // returns:
 //  -1 - unchecked block (resides in ROM, thus is integrity is constant)
@@ -989,6 +999,18 @@ void mmap_PageFaultHandler::OnPageFaultEvent( const PageFaultInfo& info, bool& h
 	uptr offset = info.addr - (uptr)eeMem->Main;
 	if( offset >= Ps2MemSize::MainRam ) return;
 
+	const uint rampage = offset >> 12;
+	m_DirtyPages[rampage] = 1;
+
+	// Pages that the recompilers don't count are only ever protected by the dirty page
+	// tracking.
+	if( m_PageProtectInfo[rampage].Mode != ProtMode_Write )
+	{
+		HostSys::MemProtect( &eeMem->Main[rampage<<12], __pagesize, PageAccess_ReadWrite() );
+		handled = true;
+		return;
+	}
+
 	mmap_ClearCpuBlock( offset );
 	handled = true;
 }
@@ -1001,5 +1023,53 @@ void mmap_ResetBlockTracking()
 {
 	//DbgCon.WriteLn( "vtlb/mmap: Block Tracking reset..." );
 	memzero( m_PageProtectInfo );
+	m_TrackDirtyPages = false;
 	if (eeMem) HostSys::MemProtect( eeMem->Main, Ps2MemSize::MainRam, PageAccess_ReadWrite() );
 }
+
+// Marks all of main memory clean, and (re)starts the dirty page tracking.  The core thread
+// must be paused.
+void mmap_ResetDirtyRamPages()
+{
+	pxAssert( eeMem );
+
+	memzero( m_DirtyPages );
+	m_TrackDirtyPages = true;
+
+	// Pages under ProtMode_Write are read-only already, so this doesn't change their state.
+	HostSys::MemProtect( eeMem->Main, Ps2MemSize::MainRam, PageAccess_ReadOnly() );
+}
+
+// Stops the dirty page tracking; every page counts as dirty until it is restarted.  The core
+// thread must be paused.
+void mmap_StopDirtyRamPages()
+{
+	if( !m_TrackDirtyPages ) return;
+	m_TrackDirtyPages = false;
+
+	if( !eeMem ) return;
+
+	// Give write access back to the pages that only the tracking was protecting, in runs.
+	const uint numPages = Ps2MemSize::MainRam >> 12;
+	for( uint rampage=0; rampage<numPages; )
+	{
+		if( m_DirtyPages[rampage] || m_PageProtectInfo[rampage].Mode == ProtMode_Write )
+		{
+			++rampage;
+			continue;
+		}
+
+		uint end = rampage + 1;
+		while( end < numPages && !m_DirtyPages[end] && m_PageProtectInfo[end].Mode != ProtMode_Write )
+			++end;
+
+		HostSys::MemProtect( &eeMem->Main[rampage<<12], (end - rampage) * __pagesize, PageAccess_ReadWrite() );
+		rampage = end;
+	}
+}
+
+// rampage - index of a 4k page of eeMem->Main.  Without tracking, every page is dirty.
+bool mmap_IsDirtyRamPage( uint rampage )
+{
+	return !m_TrackDirtyPages || m_DirtyPages[rampage];
+}
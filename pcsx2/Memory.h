@@ -120,6 +120,10 @@ extern int mmap_GetRamPageInfo( u32 paddr );
 extern void mmap_MarkCountedRamPage( u32 paddr );
 extern void mmap_ResetBlockTracking();
 
+extern void mmap_ResetDirtyRamPages();
+extern void mmap_StopDirtyRamPages();
+extern bool mmap_IsDirtyRamPage( uint rampage );
+
 #define memRead8 vtlb_memRead<mem8_t>
 #define memRead16 vtlb_memRead<mem16_t>
 #define memRead32 vtlb_memRead<mem32_t>
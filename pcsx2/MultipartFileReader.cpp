@@ -241,3 +241,41 @@ void MultipartFileReader::SetBlockSize(uint bytes)
 	}
 }
 
+
+bool MultipartFileReader::IsMapped() const
+{
+	for(uint i=0;i<m_numparts;i++)
+	{
+		if(!m_parts[i].reader->IsMapped())
+			return false;
+	}
+	return true;
+}
+
+const u8* MultipartFileReader::GetBlockPtr(uint sector)
+{
+	if(sector >= GetBlockCount())
+		return NULL;
+
+	uint i = GetFirstPart(sector);
+	return m_parts[i].reader->GetBlockPtr(sector - m_parts[i].start);
+}
+
+void MultipartFileReader::Prefetch(uint sector, uint count)
+{
+	if(sector >= GetBlockCount())
+		return;
+
+	for(uint i = GetFirstPart(sector); i < m_numparts; i++)
+	{
+		uint num = min(count, m_parts[i].end - sector);
+
+		m_parts[i].reader->Prefetch(sector - m_parts[i].start, num);
+
+		sector += num;
+		count -= num;
+
+		if(count <= 0)
+			break;
+	}
+}
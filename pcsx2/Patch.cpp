@@ -33,6 +33,12 @@ IniPatch Cheat[ MAX_CHEAT ];
 int patchnumber = 0;
 int cheatnumber = 0;
 
+// Compiled forms of Patch[] and Cheat[], rebuilt on the next apply after either list changes.
+static PatchProgram	patchProgram;
+static PatchProgram	cheatProgram;
+static bool			patchesChanged = true;
+static bool			cheatsChanged = true;
+
 wxString strgametitle;
 
 struct PatchTextTable
@@ -141,6 +147,7 @@ int InitPatches(const wxString& crc, const Game_Data& game)
 	bool patchFound = false;
 	wxString patch;
 	patchnumber = 0;
+	patchesChanged = true;
 
 	if (game.IsOk())
 	{
@@ -179,6 +186,7 @@ void inifile_process(wxTextFile &f1 )
 void ResetCheatsCount()
 {
   cheatnumber = 0;
+  cheatsChanged = true;
 }
 
 static int LoadCheatsFiles(const wxDirName& folderName, wxString& fileSpec, const wxString& friendlyName)
@@ -328,8 +336,8 @@ namespace PatchFunc
 
 			iPatch.enabled = 1; // omg success!!
 
-			if (isCheat) cheatnumber++;
-			else		 patchnumber++;
+			if (isCheat) { cheatnumber++; cheatsChanged = true; }
+			else		 { patchnumber++; patchesChanged = true; }
 		}
 		catch( wxString& exmsg )
 		{
@@ -344,19 +352,21 @@ namespace PatchFunc
 // This is for applying patches directly to memory
 void ApplyPatch(int place)
 {
-	for (int i = 0; i < patchnumber; i++)
+	if (patchesChanged)
 	{
-	    if (Patch[i].placetopatch == place)
-            _ApplyPatch(&Patch[i]);
+		patchProgram.Compile(Patch, patchnumber);
+		patchesChanged = false;
 	}
+	patchProgram.Run(place);
 }
 
 // This is for applying cheats directly to memory
 void ApplyCheat(int place)
 {
-	for (int i = 0; i < cheatnumber; i++)
+	if (cheatsChanged)
 	{
-	    if (Cheat[i].placetopatch == place)
-            _ApplyPatch(&Cheat[i]);
+		cheatProgram.Compile(Cheat, cheatnumber);
+		cheatsChanged = false;
 	}
+	cheatProgram.Run(place);
 }
@@ -18,6 +18,8 @@
 #include "Pcsx2Defs.h"
 #include "SysForwardDefs.h"
 
+#include <vector>
+
 #define MAX_PATCH 512
 #define MAX_CHEAT 1024
 
@@ -49,6 +51,34 @@ struct IniPatch
 	u64 data;
 };
 
+// --------------------------------------------------------------------------------------
+//  PatchProgram
+// --------------------------------------------------------------------------------------
+// A patch list compiled for repeated application: entries are grouped by the place they
+// apply at, disabled or malformed entries are dropped, and each entry's cpu/type dispatch is
+// resolved to a single handler.  IOP RAM targets are resolved to host pointers as well (the
+// IOP has no TLB); EE targets still go through the vtlb, since the game's TLB setup can
+// remap them between compilation and application.
+struct PatchOp;
+typedef void PatchOpHandler( const PatchOp& op );
+
+struct PatchOp
+{
+	PatchOpHandler*	handler;
+	u8*				host;		// IOP RAM target, or NULL
+	IniPatch		patch;
+};
+
+class PatchProgram
+{
+protected:
+	std::vector<PatchOp>	m_ops[2];	// indexed by placetopatch (0 = on ELF load, 1 = every vsync)
+
+public:
+	void Compile( const IniPatch* list, int count );
+	void Run( int place ) const;
+};
+
 namespace PatchFunc
 {
 	PATCHTABLEFUNC comment;
@@ -42,7 +42,7 @@ void writeCheat()
 	}
 }
 
-void handle_extended_t( IniPatch *p)
+void handle_extended_t( const IniPatch *p)
 {
 	if (SkipCount > 0)
 	{
@@ -379,3 +379,136 @@ void _ApplyPatch(IniPatch *p)
 			break;
 	}
 }
+
+// --------------------------------------------------------------------------------------
+//  PatchProgram  (implementations)
+// --------------------------------------------------------------------------------------
+
+static void PatchEE8( const PatchOp& op )
+{
+	if (memRead8(op.patch.addr) != (u8)op.patch.data)
+		memWrite8(op.patch.addr, (u8)op.patch.data);
+}
+
+static void PatchEE16( const PatchOp& op )
+{
+	if (memRead16(op.patch.addr) != (u16)op.patch.data)
+		memWrite16(op.patch.addr, (u16)op.patch.data);
+}
+
+static void PatchEE32( const PatchOp& op )
+{
+	if (memRead32(op.patch.addr) != (u32)op.patch.data)
+		memWrite32(op.patch.addr, (u32)op.patch.data);
+}
+
+static void PatchEE64( const PatchOp& op )
+{
+	u64 mem;
+	memRead64(op.patch.addr, &mem);
+	if (mem != op.patch.data)
+		memWrite64(op.patch.addr, &op.patch.data);
+}
+
+static void PatchEEExtended( const PatchOp& op )
+{
+	handle_extended_t(&op.patch);
+}
+
+// Same as iopMemWrite on RAM, minus the page lookup: writes are dropped while the cache
+// is isolated, and recompiled code covering the target is cleared.
+template< typename T >
+static void PatchIopRam( const PatchOp& op )
+{
+	T* host = (T*)op.host;
+	if (*host == (T)op.patch.data || (psxRegs.CP0.n.Status & 0x10000)) return;
+
+	*host = (T)op.patch.data;
+	psxCpu->Clear((op.patch.addr & 0x1fffffff) & ~3, 1);
+}
+
+static void PatchIop8( const PatchOp& op )
+{
+	if (iopMemRead8(op.patch.addr) != (u8)op.patch.data)
+		iopMemWrite8(op.patch.addr, (u8)op.patch.data);
+}
+
+static void PatchIop16( const PatchOp& op )
+{
+	if (iopMemRead16(op.patch.addr) != (u16)op.patch.data)
+		iopMemWrite16(op.patch.addr, (u16)op.patch.data);
+}
+
+static void PatchIop32( const PatchOp& op )
+{
+	if (iopMemRead32(op.patch.addr) != (u32)op.patch.data)
+		iopMemWrite32(op.patch.addr, (u32)op.patch.data);
+}
+
+static PatchOpHandler* GetPatchHandler( const IniPatch& p, u8*& host )
+{
+	host = NULL;
+
+	switch (p.cpu)
+	{
+		case CPU_EE:
+			switch (p.type)
+			{
+				case BYTE_T:		return PatchEE8;
+				case SHORT_T:		return PatchEE16;
+				case WORD_T:		return PatchEE32;
+				case DOUBLE_T:		return PatchEE64;
+				case EXTENDED_T:	return PatchEEExtended;
+				default:			return NULL;
+			}
+
+		case CPU_IOP:
+		{
+			// IOP main memory (2MB) is mirrored four times over the first 8MB.
+			const u32 paddr = p.addr & 0x1fffffff;
+			if (paddr < 0x00800000) host = &iopMem->Main[paddr & 0x1fffff];
+
+			switch (p.type)
+			{
+				case BYTE_T:	return host ? PatchIopRam<u8>  : PatchIop8;
+				case SHORT_T:	return host ? PatchIopRam<u16> : PatchIop16;
+				case WORD_T:	return host ? PatchIopRam<u32> : PatchIop32;
+				default:		return NULL;
+			}
+		}
+
+		default:
+			return NULL;
+	}
+}
+
+// Entries keep their relative order within a place, which extended (multi-line) cheat
+// codes depend on.
+void PatchProgram::Compile( const IniPatch* list, int count )
+{
+	for (uint place = 0; place < ArraySize(m_ops); ++place)
+		m_ops[place].clear();
+
+	for (int i = 0; i < count; ++i)
+	{
+		const IniPatch& p( list[i] );
+		if (p.enabled == 0 || (uint)p.placetopatch >= ArraySize(m_ops)) continue;
+
+		PatchOp op;
+		op.handler = GetPatchHandler(p, op.host);
+		if (!op.handler) continue;
+
+		op.patch = p;
+		m_ops[p.placetopatch].push_back(op);
+	}
+}
+
+void PatchProgram::Run( int place ) const
+{
+	if ((uint)place >= ArraySize(m_ops)) return;
+
+	const std::vector<PatchOp>& ops( m_ops[place] );
+	const size_t count = ops.size();
+	for (size_t i = 0; i < count; ++i)
+		ops[i].handler(ops[i]);
+}
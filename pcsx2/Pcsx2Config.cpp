@@ -403,6 +403,7 @@ Pcsx2Config::Pcsx2Config()
 	// Set defaults for fresh installs / reset settings
 	McdEnableEjection = true;
 	EnablePatches = true;
+	CdvdPrefetch = true;
 	BackupSavestate = true;
 }
 
@@ -412,6 +413,8 @@ void Pcsx2Config::LoadSave( IniInterface& ini )
 
 	IniBitBool( CdvdVerboseReads );
 	IniBitBool( CdvdDumpBlocks );
+	IniBitBool( CdvdPrefetch );
+	IniBitBool( CdvdMapImages );
 	IniBitBool( EnablePatches );
 	IniBitBool( EnableCheats );
 	IniBitBool( EnableWideScreenPatches );
@@ -48,6 +48,8 @@ bool iopEventAction = false;
 
 bool iopEventTestIsActive = false;
 
+IopSyncStats iopSyncStats;
+
 __aligned16 psxRegisters psxRegs;
 
 void psxReset()
@@ -61,12 +63,39 @@ void psxReset()
 	iopBreak = 0;
 	iopCycleEE = -1;
 	g_iopNextEventCycle = psxRegs.cycle + 4;
+	g_iopNextIntCycle = psxRegs.cycle;
+
+	if( iopSyncStats.Slices )
+	{
+		DevCon.WriteLn( "(IOP) Sync stats: %u slices, %llu cycles (avg %u), rapid syncs: %u, batched: %u",
+			iopSyncStats.Slices, (unsigned long long)iopSyncStats.Cycles, (u32)(iopSyncStats.Cycles / iopSyncStats.Slices),
+			iopSyncStats.RapidSyncs, iopSyncStats.BatchedSyncs );
+
+		C_ASSERT( IopSyncStats::SliceBuckets == 8 );
+		const u32* h = iopSyncStats.SliceHistogram;
+		DevCon.WriteLn( "(IOP) Slice sizes: <64: %u, <128: %u, <256: %u, <512: %u, <1024: %u, <2048: %u, <4096: %u, >=4096: %u",
+			h[0], h[1], h[2], h[3], h[4], h[5], h[6], h[7] );
+	}
+	iopSyncStats.Reset();
 
 	psxHwReset();
 
 	ioman::reset();
 }
 
+void IopSyncStats::Record( s32 eeCycles )
+{
+	if( eeCycles <= 0 ) return;
+
+	int bucket = 0;
+	for( s32 limit = 64; (bucket < SliceBuckets-1) && (eeCycles >= limit); limit <<= 1 )
+		++bucket;
+
+	++Slices;
+	Cycles += eeCycles;
+	++SliceHistogram[bucket];
+}
+
 void psxShutdown() {
 	//psxCpu->Shutdown();
 }
@@ -141,6 +170,9 @@ __fi void PSX_INT( IopEventId n, s32 ecycle )
 	psxRegs.sCycle[n] = psxRegs.cycle;
 	psxRegs.eCycle[n] = ecycle;
 
+	if( (s32)(psxRegs.cycle + ecycle - g_iopNextIntCycle) < 0 )
+		g_iopNextIntCycle = psxRegs.cycle + ecycle;
+
 	psxSetNextBranchDelta( ecycle );
 
 	if( iopCycleEE < 0 )
@@ -166,8 +198,56 @@ static __fi void IopTestEvent( IopEventId n, void (*callback)() )
 		psxSetNextBranch( psxRegs.sCycle[n], psxRegs.eCycle[n] );
 }
 
+// Events handled by _psxTestInterrupts (the SIFhack flag is never tested there).
+static const u32 TestedEvents =
+	(1 << IopEvt_SIF0) | (1 << IopEvt_SIF1) | (1 << IopEvt_SIF2) |
+#ifndef SIO_INLINE_IRQS
+	(1 << IopEvt_SIO) |
+#endif
+	(1 << IopEvt_CdvdRead) | (1 << IopEvt_Cdvd) | (1 << IopEvt_Dma11) | (1 << IopEvt_Dma12) |
+	(1 << IopEvt_Cdrom) | (1 << IopEvt_CdromRead) | (1 << IopEvt_DEV9) | (1 << IopEvt_USB);
+
+// Absolute cycle of the earliest pending IOP event, so that event tests before it can skip
+// scanning the event list.  Like its EE counterpart it may be early, but never late.
+u32 g_iopNextIntCycle = 0;
+
+static void _psxScheduleInterrupts()
+{
+	const u32 pending = psxRegs.interrupt & TestedEvents;
+	s32 nearest = 0x7fffffff;
+
+	for( uint n=0; n<=IopEvt_USB; ++n )
+	{
+		if( !(pending & (1 << n)) ) continue;
+
+		const s32 remaining = psxRegs.eCycle[n] - (s32)(psxRegs.cycle - psxRegs.sCycle[n]);
+		if( remaining < nearest ) nearest = remaining;
+	}
+
+	g_iopNextIntCycle = psxRegs.cycle + std::max( nearest, 0 );
+}
+
+// Returns true if an event which the EE and IOP must see promptly from each other is pending:
+// SIF transfers in flight on either side, or an IOP interrupt waiting to be taken.
+bool iopCrossEventPending()
+{
+	static const u32 eeSifEvents  = (1 << DMAC_SIF0) | (1 << DMAC_SIF1) | (1 << DMAC_SIF2);
+	static const u32 iopSifEvents = (1 << IopEvt_SIF0) | (1 << IopEvt_SIF1) | (1 << IopEvt_SIF2);
+
+	if( cpuRegs.interrupt & eeSifEvents ) return true;
+	if( psxRegs.interrupt & iopSifEvents ) return true;
+
+	return (psxHu32(0x1078) != 0) && ((psxHu32(0x1070) & psxHu32(0x1074)) != 0);
+}
+
 static __fi void _psxTestInterrupts()
 {
+	if( !psxTestCycle( g_iopNextIntCycle, 0 ) )
+	{
+		psxSetNextBranch( g_iopNextIntCycle, 0 );
+		return;
+	}
+
 	IopTestEvent(IopEvt_SIF0,		sif0Interrupt);	// SIF0
 	IopTestEvent(IopEvt_SIF1,		sif1Interrupt);	// SIF1
 	IopTestEvent(IopEvt_SIF2,		sif2Interrupt);	// SIF2
@@ -190,6 +270,9 @@ static __fi void _psxTestInterrupts()
 		IopTestEvent(IopEvt_DEV9,		dev9Interrupt);
 		IopTestEvent(IopEvt_USB,		usbInterrupt);
 	}
+
+	// Callbacks may have raised new events, so rescan after the fact.
+	_psxScheduleInterrupts();
 }
 
 __ri void iopEventTest()
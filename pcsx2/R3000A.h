@@ -118,6 +118,7 @@ struct psxRegisters {
 extern __aligned16 psxRegisters psxRegs;
 
 extern u32 g_iopNextEventCycle;
+extern u32 g_iopNextIntCycle;
 extern s32 iopBreak;		// used when the IOP execution is broken and control returned to the EE
 extern s32 iopCycleEE;		// tracks IOP's current sych status with the EE
 
@@ -178,6 +179,35 @@ extern bool iopEventTestIsActive;
 // Branching status used when throwing exceptions.
 extern bool iopIsDelaySlot;
 
+// --------------------------------------------------------------------------------------
+//  IopSyncStats
+// --------------------------------------------------------------------------------------
+// Tracks how the EE hands its time over to the IOP.  Slices are the number of EE cycles the
+// IOP ran per call to ExecuteBlock, bucketed by powers of two (<64, <128 ... >=4096).
+//
+struct IopSyncStats
+{
+	static const int SliceBuckets = 8;
+
+	u32 Slices;
+	u64 Cycles;
+	u32 SliceHistogram[SliceBuckets];
+
+	u32 RapidSyncs;		// early re-syncs scheduled while a cross-processor event was pending
+	u32 BatchedSyncs;	// early re-syncs deferred because nothing needed the IOP promptly
+
+	void Reset()
+	{
+		memzero( *this );
+	}
+
+	void Record( s32 eeCycles );
+};
+
+extern IopSyncStats iopSyncStats;
+
+extern bool iopCrossEventPending();
+
 // --------------------------------------------------------------------------------------
 //  R3000Acpu
 // --------------------------------------------------------------------------------------
@@ -73,6 +73,7 @@ void cpuReset()
 	fpuRegs.fprc[31]		= 0x01000001; // fpu Status/Control
 
 	g_nextEventCycle = cpuRegs.cycle + 4;
+	g_nextIntCycle = cpuRegs.cycle;
 	EEsCycle = 0;
 	EEoCycle = cpuRegs.cycle;
 
@@ -278,6 +279,34 @@ static __fi void TESTINT( u8 n, void (*callback)() )
 		cpuSetNextEvent( cpuRegs.sCycle[n], cpuRegs.eCycle[n] );
 }
 
+// Events handled by _cpuTestInterrupts; anything else in cpuRegs.interrupt is never tested
+// there, and must not hold up the schedule.
+static const u32 TestedInterrupts =
+	(1 << DMAC_VIF0) | (1 << DMAC_VIF1) | (1 << DMAC_GIF) | (1 << DMAC_FROM_IPU) | (1 << DMAC_TO_IPU) |
+	(1 << DMAC_SIF0) | (1 << DMAC_SIF1) | (1 << DMAC_SIF2) | (1 << DMAC_FROM_SPR) | (1 << DMAC_TO_SPR) |
+	(1 << DMAC_MFIFO_VIF) | (1 << DMAC_MFIFO_GIF) | (1 << VIF_VU0_FINISH) | (1 << VIF_VU1_FINISH);
+
+// Absolute cycle of the earliest pending event.  Nothing is due before this cycle, so event
+// tests before it can skip scanning the interrupt list entirely.  It may safely be early
+// (events cleared without going through here only cause an extra scan), but never late.
+u32 g_nextIntCycle = 0;
+
+static void _cpuScheduleInterrupts()
+{
+	const u32 pending = cpuRegs.interrupt & TestedInterrupts;
+	s32 nearest = 0x7fffffff;
+
+	for( uint n=0; n<=VIF_VU1_FINISH; ++n )
+	{
+		if( !(pending & (1 << n)) ) continue;
+
+		const s32 remaining = cpuRegs.eCycle[n] - (s32)(cpuRegs.cycle - cpuRegs.sCycle[n]);
+		if( remaining < nearest ) nearest = remaining;
+	}
+
+	g_nextIntCycle = cpuRegs.cycle + std::max( nearest, 0 );
+}
+
 // [TODO] move this function to LegacyDmac.cpp, and remove most of the DMAC-related headers from
 // being included into R5900.cpp.
 static __fi void _cpuTestInterrupts()
@@ -287,6 +316,13 @@ static __fi void _cpuTestInterrupts()
 		//Console.Write("DMAC Disabled or suspended");
 		return;
 	}
+
+	if( !cpuTestCycle( g_nextIntCycle, 0 ) )
+	{
+		cpuSetNextEvent( g_nextIntCycle, 0 );
+		return;
+	}
+
 	/* These are 'pcsx2 interrupts', they handle asynchronous stuff
 	   that depends on the cycle timings */
 
@@ -299,10 +335,12 @@ static __fi void _cpuTestInterrupts()
 	// The following ints are rarely called.  Encasing them in a conditional
 	// as follows helps speed up most games.
 
-	if( cpuRegs.interrupt & 0x60F19 ) // Bits 0 3 4 8 9 10 11 17 18( 1100000111100011001 )
+	if( cpuRegs.interrupt & 0x60F99 ) // Bits 0 3 4 7 8 9 10 11 17 18( 1100000111110011001 )
 	{
 		TESTINT(DMAC_VIF0,		vif0Interrupt);
 
+		TESTINT(DMAC_SIF2,		EEsif2Interrupt);
+
 		TESTINT(DMAC_FROM_IPU,	ipu0Interrupt);
 		TESTINT(DMAC_TO_IPU,	ipu1Interrupt);
 
@@ -315,6 +353,9 @@ static __fi void _cpuTestInterrupts()
 		TESTINT(VIF_VU0_FINISH, vif0VUFinish);
 		TESTINT(VIF_VU1_FINISH, vif1VUFinish);
 	}
+
+	// Callbacks may have raised new events, so rescan after the fact.
+	_cpuScheduleInterrupts();
 }
 
 static __fi void _cpuTestTIMR()
@@ -420,7 +461,9 @@ __fi void _cpuEventTest_Shared()
 		//if( EEsCycle < -450 )
 		//	Console.WriteLn( " IOP ahead by: %d cycles", -EEsCycle );
 
+		const s32 slice = EEsCycle;
 		EEsCycle = psxCpu->ExecuteBlock( EEsCycle );
+		iopSyncStats.Record( slice - EEsCycle );
 
 		iopEventAction = false;
 	}
@@ -439,9 +482,20 @@ __fi void _cpuEventTest_Shared()
 	if( EEsCycle > 192 )
 	{
 		// EE's running way ahead of the IOP still, so we should branch quickly to give the
-		// IOP extra timeslices in short order.
+		// IOP extra timeslices in short order.  Unless something is waiting on the other
+		// side (SIF transfers, IOP interrupts), there's no hurry though: let the EE run a
+		// few more blocks and hand the IOP one larger slice instead of ping-ponging.
 
-		cpuSetNextEventDelta( 48 );
+		if( iopCrossEventPending() )
+		{
+			cpuSetNextEventDelta( 48 );
+			++iopSyncStats.RapidSyncs;
+		}
+		else
+		{
+			cpuSetNextEventDelta( 192 );
+			++iopSyncStats.BatchedSyncs;
+		}
 		//Console.Warning( "EE ahead of the IOP -- Rapid Event!  %d", EEsCycle );
 	}
 
@@ -513,6 +567,9 @@ __fi void CPU_INT( EE_EventType n, s32 ecycle)
 	cpuRegs.sCycle[n] = cpuRegs.cycle;
 	cpuRegs.eCycle[n] = ecycle;
 
+	if( (s32)(cpuRegs.cycle + ecycle - g_nextIntCycle) < 0 )
+		g_nextIntCycle = cpuRegs.cycle + ecycle;
+
 	// Interrupt is happening soon: make sure both EE and IOP are aware.
 
 	if( ecycle <= 28 && iopCycleEE > 0 )
@@ -36,6 +36,10 @@ using namespace R5900;
 static void PreLoadPrep()
 {
 	SysClearExecutionCache();
+
+	// States aren't loaded from the core thread, which is the one that tracks the writes to
+	// main memory for the snapshots.
+	mmap_StopDirtyRamPages();
 }
 
 static void PostLoadPrep()
@@ -200,6 +204,13 @@ SaveStateBase& SaveStateBase::FreezeInternals()
 	Freeze(s_iLastCOP0Cycle);
 	Freeze(s_iLastPERFCycle);
 
+	// Derived from cpuRegs' event cycles; just have the next event test rescan them.
+	if (IsLoading())
+	{
+		g_nextIntCycle = cpuRegs.cycle;
+		g_iopNextIntCycle = psxRegs.cycle;
+	}
+
 	// Fourth Block - EE-related systems
 	// ---------------------------------
 	FreezeTag( "EE-Subsystems" );
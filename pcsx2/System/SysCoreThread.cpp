@@ -230,12 +230,10 @@ void SysCoreThread::GameStartingInThread()
 {
 	GetMTGS().SendGameCRC(ElfCRC);
 
+	// The analysis thread resets the debugger views once it has scanned the new ELF (right
+	// away if the debugger is showing, or else once it is shown).
 	if (EmuConfig.Debugger.EnableDebugger)
-	{
-		MIPSAnalyst::ScanForFunctions(ElfTextRange.first,ElfTextRange.first+ElfTextRange.second,true);
-		symbolMap.UpdateActiveSymbols();
-		sApp.PostAppMethod(&Pcsx2App::resetDebugger);
-	}
+		MIPSAnalyst::RestartAnalysis();
 
 	if (EmuConfig.EnablePatches) ApplyPatch(0);
 	if (EmuConfig.EnableCheats)  ApplyCheat(0);
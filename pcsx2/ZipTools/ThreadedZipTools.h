@@ -139,6 +139,83 @@ public:
 	}
 };
 
+// --------------------------------------------------------------------------------------
+//  ArchiveJobPool
+// --------------------------------------------------------------------------------------
+// Runs one job per archive member on a few worker threads (plus the calling thread), so
+// the members of an archive get compressed or decompressed in parallel.  Run() returns once
+// all the jobs are done, and rethrows the exception of any job that failed.  Nothing here is
+// specific to archives; the game library scanner uses it for disc images as well.
+//
+class ArchiveJobPool
+{
+	friend class ArchiveJobThread;
+
+protected:
+	volatile s32	m_next;
+	uint			m_count;
+
+public:
+	ArchiveJobPool()
+	{
+		m_next	= 0;
+		m_count	= 0;
+	}
+
+	virtual ~ArchiveJobPool() throw() {}
+
+	void Run( uint count );
+
+protected:
+	virtual void DoJob( uint idx )=0;
+	void RunJobs();
+};
+
+// --------------------------------------------------------------------------------------
+//  ZipArchiveReader
+// --------------------------------------------------------------------------------------
+// Minimal zip reader for savestates, written either by BaseCompressThread or by older
+// versions through wxZipOutputStream.  The archive is loaded into memory in one go, and
+// members are located through the central directory, so they can be inflated independently
+// of each other (which wxZipInputStream can't do).
+//
+class ZipArchiveReader
+{
+	DeclareNoncopyableObject( ZipArchiveReader );
+
+public:
+	struct Member
+	{
+		wxString	Name;
+		u16			Method;
+		u32			Crc;
+		uint		CompressedSize;
+		uint		Size;
+		uint		DataIndex;
+	};
+
+protected:
+	wxString				m_filename;
+	ArchiveDataBuffer		m_data;
+	std::vector<Member>		m_members;
+
+public:
+	ZipArchiveReader( const wxString& filename );
+	virtual ~ZipArchiveReader() throw() {}
+
+	bool IsOk() const { return !m_members.empty(); }
+	wxString GetStreamName() const { return m_filename; }
+
+	size_t GetLength() const { return m_members.size(); }
+	const Member& operator[]( uint idx ) const { return m_members[idx]; }
+
+	int Find( const wxString& name ) const;
+	void Extract( uint idx, ArchiveDataBuffer& dest ) const;
+
+protected:
+	bool ReadDirectory();
+};
+
 // --------------------------------------------------------------------------------------
 //  BaseCompressThread
 // --------------------------------------------------------------------------------------
@@ -20,6 +20,293 @@
 #include "ThreadedZipTools.h"
 #include "Utilities/SafeArray.inl"
 #include "wx/wfstream.h"
+#include "wx/ffile.h"
+
+#ifdef __linux__
+#include <zlib.h>
+#else
+#include <zlib/zlib.h>
+#endif
+
+// Zip record signatures and sizes (fixed part only).
+static const u32 ZipSig_LocalHeader		= 0x04034b50;
+static const u32 ZipSig_CentralHeader	= 0x02014b50;
+static const u32 ZipSig_EndOfDirectory	= 0x06054b50;
+static const uint ZipSize_LocalHeader	= 30;
+static const uint ZipSize_CentralHeader	= 46;
+static const uint ZipSize_EndOfDirectory	= 22;
+
+static const u16 ZipMethod_Store		= 0;
+static const u16 ZipMethod_Deflate		= 8;
+
+static __fi u16 ZipRead16( const u8* src ) { return src[0] | (src[1] << 8); }
+static __fi u32 ZipRead32( const u8* src ) { return src[0] | (src[1] << 8) | (src[2] << 16) | ((u32)src[3] << 24); }
+
+// --------------------------------------------------------------------------------------
+//  ArchiveJobPool  (implementations)
+// --------------------------------------------------------------------------------------
+class ArchiveJobThread : public pxThread
+{
+	typedef pxThread _parent;
+
+protected:
+	ArchiveJobPool&		m_pool;
+
+public:
+	ArchiveJobThread( ArchiveJobPool& pool )
+		: _parent( L"ArchiveJob" )
+		, m_pool( pool )
+	{
+	}
+
+	virtual ~ArchiveJobThread() throw()
+	{
+		_parent::Cancel();
+	}
+
+protected:
+	void ExecuteTaskInThread()
+	{
+		m_pool.RunJobs();
+	}
+};
+
+void ArchiveJobPool::RunJobs()
+{
+	while( true )
+	{
+		const uint idx = AtomicExchangeAdd( m_next, 1 );
+		if( idx >= m_count ) break;
+		DoJob( idx );
+	}
+}
+
+void ArchiveJobPool::Run( uint count )
+{
+	m_next	= 0;
+	m_count	= count;
+
+	if( !count ) return;
+
+	const uint numThreads = std::min( count, std::max( x86caps.LogicalCores, 1u ) ) - 1;
+	ScopedPtr<ArchiveJobThread> threads[8];
+
+	for( uint i=0; i<numThreads && i<ArraySize(threads); ++i )
+	{
+		threads[i] = new ArchiveJobThread( *this );
+		threads[i]->Start();
+	}
+
+	// If a job throws, the other threads still need to be joined before the pool goes away
+	// (the thread destructors take care of that).
+
+	RunJobs();
+
+	for( uint i=0; i<ArraySize(threads); ++i )
+	{
+		if( !threads[i] ) continue;
+		threads[i]->Block();
+		threads[i]->RethrowException();
+	}
+}
+
+// --------------------------------------------------------------------------------------
+//  ZipArchiveReader  (implementations)
+// --------------------------------------------------------------------------------------
+ZipArchiveReader::ZipArchiveReader( const wxString& filename )
+	: m_filename( filename )
+	, m_data( L"ZipArchiveReader" )
+{
+	wxFFile file( filename, L"rb" );
+	if( !file.IsOpened() )
+		throw Exception::CannotCreateStream( filename ).SetDiagMsg(L"Cannot open file for reading.");
+
+	const wxFileOffset length = file.Length();
+	if( length <= 0 || length >= 0x7fffffff ) return;
+
+	m_data.ExactAlloc( (int)length );
+	if( file.Read( m_data.GetPtr(), length ) != (size_t)length )
+		throw Exception::BadStream( filename ).SetDiagMsg(L"Error reading the archive.");
+
+	if( !ReadDirectory() )
+		m_members.clear();
+}
+
+// Returns false if the archive is not a (supported) zip file.
+bool ZipArchiveReader::ReadDirectory()
+{
+	const uint length = m_data.GetSizeInBytes();
+	if( length < ZipSize_EndOfDirectory ) return false;
+
+	// The end of directory record sits at the very end of the file, followed only by a
+	// comment (of at most 64k).
+
+	const u8* data = m_data.GetPtr();
+	int eod = length - ZipSize_EndOfDirectory;
+	const int eodLimit = std::max( 0, eod - 0xffff );
+
+	while( eod >= eodLimit && ZipRead32( &data[eod] ) != ZipSig_EndOfDirectory ) --eod;
+	if( eod < eodLimit ) return false;
+
+	const uint count	= ZipRead16( &data[eod + 10] );
+	uint pos			= ZipRead32( &data[eod + 16] );
+
+	for( uint i=0; i<count; ++i )
+	{
+		if( pos + ZipSize_CentralHeader > length || ZipRead32( &data[pos] ) != ZipSig_CentralHeader ) return false;
+
+		Member member;
+		member.Method			= ZipRead16( &data[pos + 10] );
+		member.Crc				= ZipRead32( &data[pos + 16] );
+		member.CompressedSize	= ZipRead32( &data[pos + 20] );
+		member.Size				= ZipRead32( &data[pos + 24] );
+
+		const uint nameLen		= ZipRead16( &data[pos + 28] );
+		const uint extraLen		= ZipRead16( &data[pos + 30] );
+		const uint commentLen	= ZipRead16( &data[pos + 32] );
+		const uint local		= ZipRead32( &data[pos + 42] );
+
+		if( pos + ZipSize_CentralHeader + nameLen > length ) return false;
+		member.Name = fromUTF8( std::string( (const char*)&data[pos + ZipSize_CentralHeader], nameLen ).c_str() );
+
+		// The local header repeats the name, but may have an extra field of its own.
+		if( local + ZipSize_LocalHeader > length || ZipRead32( &data[local] ) != ZipSig_LocalHeader ) return false;
+		member.DataIndex = local + ZipSize_LocalHeader + ZipRead16( &data[local + 26] ) + ZipRead16( &data[local + 28] );
+
+		if( member.DataIndex + member.CompressedSize > length ) return false;
+		if( member.Method != ZipMethod_Store && member.Method != ZipMethod_Deflate ) return false;
+
+		m_members.push_back( member );
+		pos += ZipSize_CentralHeader + nameLen + extraLen + commentLen;
+	}
+
+	return true;
+}
+
+int ZipArchiveReader::Find( const wxString& name ) const
+{
+	for( uint i=0; i<m_members.size(); ++i )
+	{
+		if( m_members[i].Name.CmpNoCase( name ) == 0 ) return i;
+	}
+	return -1;
+}
+
+// Decompresses the given member into dest (which is resized to fit).  Safe to call from
+// several threads at once, for different members.
+void ZipArchiveReader::Extract( uint idx, ArchiveDataBuffer& dest ) const
+{
+	const Member& member = m_members[idx];
+	const u8* src = m_data.GetPtr( member.DataIndex );
+
+	dest.ExactAlloc( std::max( member.Size, 1u ) );
+
+	if( member.Method == ZipMethod_Store )
+	{
+		if( member.CompressedSize != member.Size )
+			throw Exception::BadStream( m_filename ).SetDiagMsg(pxsFmt( L"Archive member '%s' is corrupted.", WX_STR(member.Name) ));
+
+		memcpy_fast( dest.GetPtr(), src, member.Size );
+	}
+	else
+	{
+		z_stream strm;
+		memzero( strm );
+
+		if( inflateInit2( &strm, -MAX_WBITS ) != Z_OK )
+			throw Exception::OutOfMemory( L"ZipArchiveReader::Extract" );
+
+		strm.next_in	= (Bytef*)src;
+		strm.avail_in	= member.CompressedSize;
+		strm.next_out	= dest.GetPtr();
+		strm.avail_out	= member.Size;
+
+		const int result = inflate( &strm, Z_FINISH );
+		inflateEnd( &strm );
+
+		if( result != Z_STREAM_END || strm.total_out != member.Size )
+			throw Exception::BadStream( m_filename ).SetDiagMsg(pxsFmt( L"Archive member '%s' is corrupted.", WX_STR(member.Name) ));
+	}
+
+	if( crc32( 0, dest.GetPtr(), member.Size ) != member.Crc )
+		throw Exception::BadStream( m_filename ).SetDiagMsg(pxsFmt( L"Archive member '%s' failed its CRC check.", WX_STR(member.Name) ));
+}
+
+// --------------------------------------------------------------------------------------
+//  BaseCompressThread  (implementations)
+// --------------------------------------------------------------------------------------
+
+struct DeflatedEntry
+{
+	u16				Method;
+	u32				Crc;
+	std::vector<u8>	Data;
+};
+
+// Compresses every entry of the list, in parallel.  Savestates favor speed over size, so
+// this uses deflate's fastest level; entries that don't shrink are stored as is.
+class DeflateJobs : public ArchiveJobPool
+{
+protected:
+	const ArchiveEntryList&		m_list;
+	DeflatedEntry*				m_dest;
+
+public:
+	DeflateJobs( const ArchiveEntryList& list, DeflatedEntry* dest )
+		: m_list( list )
+	{
+		m_dest = dest;
+	}
+
+	virtual ~DeflateJobs() throw() {}
+
+protected:
+	void DoJob( uint idx )
+	{
+		const ArchiveEntry& entry = m_list[idx];
+		DeflatedEntry& dest = m_dest[idx];
+
+		const u8* src = m_list.GetPtr( entry.GetDataIndex() );
+		const uint size = entry.GetDataSize();
+
+		dest.Crc = crc32( 0, src, size );
+
+		z_stream strm;
+		memzero( strm );
+
+		if( deflateInit2( &strm, Z_BEST_SPEED, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY ) != Z_OK )
+			throw Exception::OutOfMemory( L"DeflateJobs" );
+
+		dest.Data.resize( deflateBound( &strm, size ) );
+
+		strm.next_in	= (Bytef*)src;
+		strm.avail_in	= size;
+		strm.next_out	= &dest.Data[0];
+		strm.avail_out	= dest.Data.size();
+
+		const int result = deflate( &strm, Z_FINISH );
+		deflateEnd( &strm );
+
+		if( result == Z_STREAM_END && strm.total_out < size )
+		{
+			dest.Method = ZipMethod_Deflate;
+			dest.Data.resize( strm.total_out );
+		}
+		else
+		{
+			dest.Method = ZipMethod_Store;
+			dest.Data.assign( src, src + size );
+		}
+	}
+};
+
+static u32 GetZipDosTime()
+{
+	const wxDateTime now( wxDateTime::Now() );
+
+	return	((now.GetYear() - 1980) << 25) | ((now.GetMonth() + 1) << 21) | (now.GetDay() << 16) |
+			(now.GetHour() << 11) | (now.GetMinute() << 5) | (now.GetSecond() >> 1);
+}
 
 
 BaseCompressThread::~BaseCompressThread() throw()
@@ -52,28 +339,88 @@ void BaseCompressThread::ExecuteTaskInThread()
 	
 	Yield( 3 );
 
-	uint listlen = m_src_list->GetLength();
+	// Compress all the entries at once, then write them out as a zip archive.  Entries with
+	// no data are skipped altogether.
+
+	const uint listlen = m_src_list->GetLength();
+	ScopedArray<DeflatedEntry> deflated( listlen );
+
+	DeflateJobs( *m_src_list, deflated.GetPtr() ).Run( listlen );
+
+	const u32 dostime = GetZipDosTime();
+	std::vector<u32> offsets( listlen );
+	u32 pos = 0;
+
+	for( uint i=0; i<listlen; ++i )
+	{
+		const ArchiveEntry& entry = (*m_src_list)[i];
+		if (!entry.GetDataSize()) continue;
+
+		const DeflatedEntry& data = deflated[i];
+		const wxCharBuffer name( entry.GetFilename().ToUTF8() );
+		const u16 nameLen = strlen( name );
+
+		offsets[i] = pos;
+
+		m_gzfp->Write( ZipSig_LocalHeader );
+		m_gzfp->Write( (u16)20 );						// version needed to extract
+		m_gzfp->Write( (u16)0 );						// flags
+		m_gzfp->Write( data.Method );
+		m_gzfp->Write( dostime );
+		m_gzfp->Write( data.Crc );
+		m_gzfp->Write( (u32)data.Data.size() );
+		m_gzfp->Write( (u32)entry.GetDataSize() );
+		m_gzfp->Write( nameLen );
+		m_gzfp->Write( (u16)0 );						// extra field length
+		m_gzfp->Write( name.data(), nameLen );
+		m_gzfp->Write( &data.Data[0], data.Data.size() );
+
+		pos += ZipSize_LocalHeader + nameLen + data.Data.size();
+	}
+
+	const u32 directory = pos;
+	u16 count = 0;
+
 	for( uint i=0; i<listlen; ++i )
 	{
 		const ArchiveEntry& entry = (*m_src_list)[i];
 		if (!entry.GetDataSize()) continue;
 
-		wxArchiveOutputStream& woot = *(wxArchiveOutputStream*)m_gzfp->GetWxStreamBase();
-		woot.PutNextEntry( entry.GetFilename() );
+		const DeflatedEntry& data = deflated[i];
+		const wxCharBuffer name( entry.GetFilename().ToUTF8() );
+		const u16 nameLen = strlen( name );
 
-		static const uint BlockSize = 0x64000;
-		uint curidx = 0;
+		m_gzfp->Write( ZipSig_CentralHeader );
+		m_gzfp->Write( (u16)20 );						// version made by
+		m_gzfp->Write( (u16)20 );						// version needed to extract
+		m_gzfp->Write( (u16)0 );						// flags
+		m_gzfp->Write( data.Method );
+		m_gzfp->Write( dostime );
+		m_gzfp->Write( data.Crc );
+		m_gzfp->Write( (u32)data.Data.size() );
+		m_gzfp->Write( (u32)entry.GetDataSize() );
+		m_gzfp->Write( nameLen );
+		m_gzfp->Write( (u16)0 );						// extra field length
+		m_gzfp->Write( (u16)0 );						// comment length
+		m_gzfp->Write( (u16)0 );						// disk number
+		m_gzfp->Write( (u16)0 );						// internal attributes
+		m_gzfp->Write( (u32)0 );						// external attributes
+		m_gzfp->Write( offsets[i] );
+		m_gzfp->Write( name.data(), nameLen );
 
-		do {
-			uint thisBlockSize = std::min( BlockSize, entry.GetDataSize() - curidx );
-			m_gzfp->Write(m_src_list->GetPtr( entry.GetDataIndex() + curidx ), thisBlockSize);
-			curidx += thisBlockSize;
-			Yield( 2 );
-		} while( curidx < entry.GetDataSize() );
-		
-		woot.CloseEntry();
+		pos += ZipSize_CentralHeader + nameLen;
+		++count;
 	}
 
+	m_gzfp->Write( ZipSig_EndOfDirectory );
+	m_gzfp->Write( (u16)0 );							// disk number
+	m_gzfp->Write( (u16)0 );							// disk with the directory
+	m_gzfp->Write( count );
+	m_gzfp->Write( count );
+	m_gzfp->Write( pos - directory );
+	m_gzfp->Write( directory );
+	m_gzfp->Write( (u16)0 );							// comment length
+
 	m_gzfp->Close();
 
 	if( !wxRenameFile( m_gzfp->GetStreamName(), m_final_filename, true ) )
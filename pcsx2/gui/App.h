@@ -93,6 +93,7 @@ enum MenuIdentifiers
 	MenuId_Boot_CDVD,
 	MenuId_Boot_CDVD2,
 	MenuId_Boot_ELF,
+	MenuId_Cdvd_ScanGames,		// Identifies the disc images of a folder (see GameLibrary)
 	//MenuId_Boot_Recent,			// Menu populated with recent source bootings
 
 
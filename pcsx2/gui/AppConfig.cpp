@@ -458,6 +458,13 @@ wxDirName GetLogFolder()
 	return g_Conf->Folders.IsDefault( FolderId_Logs ) ? PathDefs::Get(FolderId_Logs) : g_Conf->Folders[FolderId_Logs];
 }
 
+// Holds data that can always be rebuilt (ISO filesystem indexes and the like).  Callers
+// create it when they first write to it.
+wxDirName GetCacheFolder()
+{
+	return GetSettingsFolder().Combine( wxDirName(L"cache") );
+}
+
 wxDirName GetSettingsFolder()
 {
 	if( wxGetApp().Overrides.SettingsFolder.IsOk() )
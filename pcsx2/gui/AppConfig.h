@@ -67,6 +67,7 @@ extern wxString  GetUiSettingsFilename();
 extern wxString  GetUiKeysFilename();
 
 extern wxDirName GetLogFolder();
+extern wxDirName GetCacheFolder();
 
 enum InstallationModeType
 {
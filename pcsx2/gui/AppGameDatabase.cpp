@@ -17,6 +17,7 @@
 #include "App.h"
 #include "AppGameDatabase.h"
 #include <wx/stdpaths.h>
+#include <wx/ffile.h>
 
 class DBLoaderHelper
 {
@@ -146,6 +147,383 @@ void DBLoaderHelper::ReadGames()
 	}
 }
 
+// --------------------------------------------------------------------------------------
+//  GameIndex.dbc  (compiled database cache)
+// --------------------------------------------------------------------------------------
+// Layout, all offsets relative to the start of the file and all fields 32-bit aligned:
+//
+//   GameDbCacheHeader
+//   u32[BucketCount]   hash displacement seed of each bucket
+//   u32[SlotCount]     record offset of each hash slot, or GameDbCacheEmpty
+//   records            u32 serial, u32 keyCount, keyCount x (u32 key, u32 value); file order
+//   strings            u32 length followed by UTF-8 text, padded to 4 bytes; deduplicated
+//
+// Lookups hash the serial with seed 0 to pick a bucket, and hash it again with that bucket's
+// seed to pick a slot.  The seeds are chosen at build time so that no two serials share a
+// slot; the serial stored in the record still has to be compared, since unknown serials
+// land in arbitrary slots.  The cache is native-endian and only ever used on the machine
+// that built it.
+
+static const u32 GameDbCacheMagic	= 0x43424447;	// "GDBC"
+static const u32 GameDbCacheVersion	= 1;
+static const u32 GameDbCacheEmpty	= (u32)-1;
+
+struct GameDbCacheHeader
+{
+	u32		Magic;
+	u32		Version;
+	s64		SourceTime;		// modification time of the text database the cache was built from
+	u64		SourceSize;		// ... and its size
+	u32		FileSize;
+	u32		GameCount;
+	u32		BucketCount;
+	u32		SlotCount;
+	u32		Buckets;
+	u32		Slots;
+	u32		Records;
+	u32		HeaderText;		// string holding the text database's comment header
+};
+
+static void GetSourceStamp(const wxString& source, s64& time, u64& size)
+{
+	wxFileName fn(source);
+	time = fn.GetModificationTime().GetValue().GetValue();
+	size = fn.GetSize().GetValue();
+}
+
+// Case-insensitive (ASCII) FNV-1a, with a final mix so that the low bits used by the
+// modulo depend on the whole serial.
+static u32 SerialHash(const char* serial, uint length, u32 seed)
+{
+	u32 hash = 2166136261u ^ (seed * 0x9e3779b9u);
+	for (uint i = 0; i < length; ++i)
+	{
+		u8 c = serial[i];
+		if (c >= 'a' && c <= 'z') c -= 'a' - 'A';
+		hash = (hash ^ c) * 16777619u;
+	}
+	hash ^= hash >> 16;
+	hash *= 0x85ebca6bu;
+	hash ^= hash >> 13;
+	return hash;
+}
+
+static bool SerialEquals(const char* a, uint alen, const char* b, uint blen)
+{
+	if (alen != blen) return false;
+	for (uint i = 0; i < alen; ++i)
+	{
+		u8 ca = a[i], cb = b[i];
+		if (ca >= 'a' && ca <= 'z') ca -= 'a' - 'A';
+		if (cb >= 'a' && cb <= 'z') cb -= 'a' - 'A';
+		if (ca != cb) return false;
+	}
+	return true;
+}
+
+static std::string SerialUpper(const wxString& serial)
+{
+	std::string result(serial.ToUTF8());
+	for (size_t i = 0; i < result.length(); ++i)
+		if (result[i] >= 'a' && result[i] <= 'z') result[i] -= 'a' - 'A';
+	return result;
+}
+
+class GameDbCacheWriter
+{
+	DeclareNoncopyableObject( GameDbCacheWriter );
+
+protected:
+	std::vector<u32>						m_strings;		// built in u32 units, keeps everything aligned
+	std::unordered_map<std::string, u32>	m_interned;
+	u32										m_stringBase;
+
+public:
+	GameDbCacheWriter(u32 stringBase)
+		: m_stringBase(stringBase)
+	{
+	}
+
+	const std::vector<u32>& GetStrings() const { return m_strings; }
+
+	// Returns the file offset of the given string, adding it to the pool if needed.
+	u32 Intern(const wxString& src)
+	{
+		const std::string utf8(src.ToUTF8());
+
+		std::unordered_map<std::string, u32>::const_iterator it(m_interned.find(utf8));
+		if (it != m_interned.end()) return it->second;
+
+		const u32 offset = m_stringBase + m_strings.size() * 4;
+		const size_t pos = m_strings.size();
+		m_strings.resize(pos + 1 + (utf8.length() + 3) / 4, 0);
+		m_strings[pos] = utf8.length();
+		if (!utf8.empty()) memcpy(&m_strings[pos + 1], utf8.data(), utf8.length());
+
+		m_interned[utf8] = offset;
+		return offset;
+	}
+};
+
+struct LargerBucket
+{
+	const std::vector< std::vector<uint> >& members;
+
+	LargerBucket(const std::vector< std::vector<uint> >& _members) : members(_members) {}
+
+	bool operator()(uint a, uint b) const { return members[a].size() > members[b].size(); }
+};
+
+// Assigns every serial a unique slot (hash and displace).  Buckets are placed largest first,
+// each trying seeds until all of its serials land in free slots.  Returns false if some
+// bucket cannot be placed, which in practice only happens with duplicate serials.
+static bool BuildPerfectHash(const std::vector<std::string>& serials, const std::vector<u32>& records,
+							 std::vector<u32>& buckets, std::vector<u32>& slots)
+{
+	const uint count = serials.size();
+	buckets.assign(count / 2 + 1, 0);
+	slots.assign(count + count / 4 + 1, GameDbCacheEmpty);
+
+	std::vector< std::vector<uint> > members(buckets.size());
+	for (uint i = 0; i < count; ++i)
+		members[SerialHash(serials[i].data(), serials[i].length(), 0) % buckets.size()].push_back(i);
+
+	std::vector<uint> order(buckets.size());
+	for (uint b = 0; b < order.size(); ++b) order[b] = b;
+	std::stable_sort(order.begin(), order.end(), LargerBucket(members));
+
+	std::vector<u32> placed;
+	for (uint o = 0; o < order.size(); ++o)
+	{
+		const std::vector<uint>& bucket(members[order[o]]);
+		if (bucket.empty()) break;
+
+		u32 seed = 1;
+		for (; seed < 0x10000; ++seed)
+		{
+			placed.clear();
+			for (uint m = 0; m < bucket.size(); ++m)
+			{
+				const std::string& serial(serials[bucket[m]]);
+				const u32 slot = SerialHash(serial.data(), serial.length(), seed) % slots.size();
+				if (slots[slot] != GameDbCacheEmpty || std::find(placed.begin(), placed.end(), slot) != placed.end()) break;
+				placed.push_back(slot);
+			}
+			if (placed.size() == bucket.size()) break;
+		}
+		if (seed >= 0x10000) return false;
+
+		buckets[order[o]] = seed;
+		for (uint m = 0; m < bucket.size(); ++m)
+			slots[placed[m]] = records[bucket[m]];
+	}
+	return true;
+}
+
+bool AppGameDatabase::WriteCache(const wxString& cachefile, const wxString& source) const
+{
+	// Collect the games in file order.  Later duplicates of a serial replace earlier ones
+	// in the hash (same as the text loader), and only the first spelling of a serial that
+	// differs in case only is kept.
+	std::vector<const Game_Data*> games;
+	std::vector<std::string> serials;
+	std::unordered_map<std::string, uint> seen;
+
+	for (uint blockidx=0; blockidx<=m_BlockTableWritePos; ++blockidx)
+	{
+		if( !m_BlockTable[blockidx] ) continue;
+
+		const uint endidx = (blockidx == m_BlockTableWritePos) ? m_CurBlockWritePos : m_GamesPerBlock;
+
+		for( uint gameidx=0; gameidx<endidx; ++gameidx )
+		{
+			const Game_Data* game = &m_BlockTable[blockidx][gameidx];
+			GameDataHash::const_iterator it( gHash.find(game->id) );
+			if (it == gHash.end() || it->second != game) continue;
+
+			std::string serial(SerialUpper(game->id));
+			if (serial.empty() || seen.find(serial) != seen.end()) continue;
+
+			seen[serial] = games.size();
+			games.push_back(game);
+			serials.push_back(serial);
+		}
+	}
+
+	const u32 count = games.size();
+	const u32 bucketCount = count / 2 + 1;
+	const u32 slotCount = count + count / 4 + 1;
+
+	GameDbCacheHeader hdr;
+	memzero(hdr);
+	hdr.Magic		= GameDbCacheMagic;
+	hdr.Version		= GameDbCacheVersion;
+	hdr.GameCount	= count;
+	hdr.BucketCount	= bucketCount;
+	hdr.SlotCount	= slotCount;
+	hdr.Buckets		= sizeof(hdr);
+	hdr.Slots		= hdr.Buckets + bucketCount * 4;
+	hdr.Records		= hdr.Slots + slotCount * 4;
+	GetSourceStamp(source, hdr.SourceTime, hdr.SourceSize);
+
+	u32 recordWords = 0;
+	for (u32 i = 0; i < count; ++i)
+		recordWords += 2 + games[i]->kList.size() * 2;
+
+	GameDbCacheWriter strings(hdr.Records + recordWords * 4);
+	std::vector<u32> records;
+	std::vector<u32> recordOffsets(count);
+	records.reserve(recordWords);
+
+	for (u32 i = 0; i < count; ++i)
+	{
+		const Game_Data& game(*games[i]);
+		recordOffsets[i] = hdr.Records + records.size() * 4;
+
+		records.push_back(strings.Intern(game.id));
+		records.push_back(game.kList.size());
+		for (KeyPairArray::const_iterator it(game.kList.begin()); it != game.kList.end(); ++it)
+		{
+			records.push_back(strings.Intern(it->key));
+			records.push_back(strings.Intern(it->value));
+		}
+	}
+	hdr.HeaderText = strings.Intern(header);
+	hdr.FileSize = hdr.Records + (records.size() + strings.GetStrings().size()) * 4;
+
+	std::vector<u32> buckets, slots;
+	if (!BuildPerfectHash(serials, recordOffsets, buckets, slots))
+	{
+		Console.Warning("(GameDB) Could not build the serial hash; the database will not be cached.");
+		return false;
+	}
+
+	const wxString tmpfile(cachefile + L".tmp");
+	{
+		wxFFile out(tmpfile, L"wb");
+		if (!out.IsOpened()) return false;
+
+		bool ok = out.Write(&hdr, sizeof(hdr)) == sizeof(hdr);
+		ok = ok && out.Write(&buckets[0], buckets.size() * 4) == buckets.size() * 4;
+		ok = ok && out.Write(&slots[0], slots.size() * 4) == slots.size() * 4;
+		if (!records.empty())
+			ok = ok && out.Write(&records[0], records.size() * 4) == records.size() * 4;
+		ok = ok && out.Write(&strings.GetStrings()[0], strings.GetStrings().size() * 4) == strings.GetStrings().size() * 4;
+		ok = out.Close() && ok;
+
+		if (!ok)
+		{
+			wxRemoveFile(tmpfile);
+			return false;
+		}
+	}
+
+	// Replace the old cache only once the new one is complete.
+	return wxRenameFile(tmpfile, cachefile, true);
+}
+
+bool AppGameDatabase::LoadCache(const wxString& cachefile, const wxString& source)
+{
+	UnloadCache();
+
+	size_t size;
+	const u8* view = (const u8*)HostSys::MmapFile(cachefile, size);
+	if (!view) return false;
+
+	const GameDbCacheHeader& hdr(*(const GameDbCacheHeader*)view);
+
+	s64 time;
+	u64 length;
+	GetSourceStamp(source, time, length);
+
+	bool valid = size >= sizeof(hdr)
+		&& hdr.Magic == GameDbCacheMagic && hdr.Version == GameDbCacheVersion
+		&& hdr.SourceTime == time && hdr.SourceSize == length && hdr.FileSize == size
+		&& hdr.BucketCount != 0 && hdr.SlotCount != 0
+		&& hdr.Buckets == sizeof(hdr)
+		&& hdr.Slots == hdr.Buckets + (u64)hdr.BucketCount * 4
+		&& hdr.Records == hdr.Slots + (u64)hdr.SlotCount * 4
+		&& hdr.Records <= size;
+
+	if (!valid)
+	{
+		HostSys::MunmapFile((void*)view, size);
+		return false;
+	}
+
+	m_cache = view;
+	m_cacheSize = size;
+	DecodeCachedString(hdr.HeaderText, header);
+	return true;
+}
+
+void AppGameDatabase::UnloadCache()
+{
+	HostSys::MunmapFile((void*)m_cache, m_cacheSize);
+	m_cache = NULL;
+	m_cacheSize = 0;
+}
+
+// The cache file is validated as a whole when loaded; individual offsets are still checked
+// against its bounds here, so that a damaged file produces misses rather than crashes.
+bool AppGameDatabase::DecodeCachedString(u32 offset, wxString& dest) const
+{
+	if ((offset & 3) || (u64)offset + 4 > m_cacheSize) return false;
+
+	const u32 length = *(const u32*)&m_cache[offset];
+	if ((u64)offset + 4 + length > m_cacheSize) return false;
+
+	dest = wxString::FromUTF8((const char*)&m_cache[offset + 4], length);
+	return true;
+}
+
+bool AppGameDatabase::DecodeCachedGame(u32 offset, Game_Data& dest) const
+{
+	dest.clear();
+	if ((offset & 3) || (u64)offset + 8 > m_cacheSize) return false;
+
+	const u32* record = (const u32*)&m_cache[offset];
+	const u32 keys = record[1];
+	if ((u64)offset + 8 + (u64)keys * 8 > m_cacheSize) return false;
+	if (!DecodeCachedString(record[0], dest.id)) return false;
+
+	dest.kList.resize(keys);
+	for (u32 i = 0; i < keys; ++i)
+	{
+		if (!DecodeCachedString(record[2 + i*2], dest.kList[i].key) ||
+			!DecodeCachedString(record[3 + i*2], dest.kList[i].value))
+		{
+			dest.clear();
+			return false;
+		}
+	}
+	return true;
+}
+
+bool AppGameDatabase::findCachedGame(Game_Data& dest, const wxString& id) const
+{
+	const GameDbCacheHeader& hdr(CacheHeader());
+	const u32* buckets = (const u32*)&m_cache[hdr.Buckets];
+	const u32* slots = (const u32*)&m_cache[hdr.Slots];
+
+	const wxCharBuffer serial(id.ToUTF8());
+	const uint length = strlen(serial.data());
+
+	const u32 seed = buckets[SerialHash(serial.data(), length, 0) % hdr.BucketCount];
+	const u32 offset = slots[SerialHash(serial.data(), length, seed) % hdr.SlotCount];
+	if (offset == GameDbCacheEmpty) return false;
+
+	// Compare the serial in place before decoding anything else.
+	if ((offset & 3) || (u64)offset + 8 > m_cacheSize) return false;
+	const u32 idOffset = ((const u32*)&m_cache[offset])[0];
+	if ((idOffset & 3) || (u64)idOffset + 4 > m_cacheSize) return false;
+	const u32 idLength = *(const u32*)&m_cache[idOffset];
+	if ((u64)idOffset + 4 + idLength > m_cacheSize) return false;
+	if (!SerialEquals(serial.data(), length, (const char*)&m_cache[idOffset + 4], idLength)) return false;
+
+	return DecodeCachedGame(offset, dest);
+}
+
 // --------------------------------------------------------------------------------------
 //  AppGameDatabase  (implementations)
 // --------------------------------------------------------------------------------------
@@ -176,6 +554,20 @@ AppGameDatabase& AppGameDatabase::LoadFromFile(const wxString& _file, const wxSt
 		return *this;
 	}
 
+	const wxString cachefile( GetSettingsFolder().Combine( wxFileName(L"GameIndex.dbc") ).GetFullPath() );
+
+	u64 qpc_Start = GetCPUTicks();
+
+	if (LoadCache(cachefile, file))
+	{
+		u64 qpc_end = GetCPUTicks();
+
+		Console.WriteLn( "(GameDB) %d games on record (mapped from cache in %ums)",
+			CacheHeader().GameCount + gHash.size(), (u32)(((qpc_end-qpc_Start)*1000) / GetTickFrequency()) );
+
+		return *this;
+	}
+
 	wxFFileInputStream reader( file );
 
 	if (!reader.IsOk())
@@ -186,7 +578,6 @@ AppGameDatabase& AppGameDatabase::LoadFromFile(const wxString& _file, const wxSt
 
 	DBLoaderHelper loader( reader, *this );
 
-	u64 qpc_Start = GetCPUTicks();
 	header = loader.ReadHeader();
 	loader.ReadGames();
 	u64 qpc_end = GetCPUTicks();
@@ -194,30 +585,65 @@ AppGameDatabase& AppGameDatabase::LoadFromFile(const wxString& _file, const wxSt
 	Console.WriteLn( "(GameDB) %d games on record (loaded in %ums)",
 		gHash.size(), (u32)(((qpc_end-qpc_Start)*1000) / GetTickFrequency()) );
 
+	// The parsed games stay in memory for this session; the cache serves the next ones.
+	if (!WriteCache(cachefile, file))
+		Console.Warning(L"(GameDB) Could not write the database cache [%s]", WX_STR(cachefile));
+
 	return *this;
 }
 
+bool AppGameDatabase::findGame(Game_Data& dest, const wxString& id)
+{
+	// Games created or edited at runtime shadow the cached ones.
+	if (BaseGameDatabaseImpl::findGame(dest, id)) return true;
+	return m_cache && findCachedGame(dest, id);
+}
+
+static void WriteGame(wxOutputStream& writer, const Game_Data& game)
+{
+	KeyPairArray::const_iterator i(game.kList.begin());
+	for ( ; i != game.kList.end(); ++i) {
+		pxWriteMultiline(writer, i->toString() );
+	}
+
+	pxWriteLine(writer, L"---------------------------------------------");
+}
+
 // Saves changes to the database
 
 void AppGameDatabase::SaveToFile(const wxString& file) {
 	wxFFileOutputStream writer( file );
 	pxWriteMultiline(writer, header);
 
+	// Cached games keep their original order, with any edits made at runtime applied.
+	if (m_cache)
+	{
+		const GameDbCacheHeader& hdr(CacheHeader());
+		Game_Data game;
+
+		u32 offset = hdr.Records;
+		for (u32 i = 0; i < hdr.GameCount && DecodeCachedGame(offset, game); ++i)
+		{
+			offset += 8 + game.kList.size() * 8;
+
+			GameDataHash::const_iterator it( gHash.find(game.id) );
+			WriteGame(writer, (it != gHash.end()) ? *it->second : game);
+		}
+	}
+
+	Game_Data cached;
 	for(uint blockidx=0; blockidx<=m_BlockTableWritePos; ++blockidx)
 	{
 		if( !m_BlockTable[blockidx] ) continue;
 
 		const uint endidx = (blockidx == m_BlockTableWritePos) ? m_CurBlockWritePos : m_GamesPerBlock;
 
-		for( uint gameidx=0; gameidx<=endidx; ++gameidx )
+		for( uint gameidx=0; gameidx<endidx; ++gameidx )
 		{
 			const Game_Data& game( m_BlockTable[blockidx][gameidx] );
-			KeyPairArray::const_iterator i(game.kList.begin());
-			for ( ; i != game.kList.end(); ++i) {
-				pxWriteMultiline(writer, i->toString() );
-			}
+			if (m_cache && findCachedGame(cached, game.id)) continue;
 
-			pxWriteLine(writer, L"---------------------------------------------");
+			WriteGame(writer, game);
 		}
 	}
 }
@@ -38,6 +38,14 @@
 // After the constructor loads the game data, you can use the
 // GameDatabase class's methods to get the other key's values.
 // Such as dbLoader.getString("Region") returns "NTSC-U"
+//
+// The text database is compiled into a binary cache (GameIndex.dbc, in the settings folder)
+// the first time it is parsed, and the cache is memory-mapped on later runs for as long as
+// the text file is unchanged.  Cached games are looked up through a perfect hash of their
+// serial, and only the game being looked up gets decoded into a Game_Data.  Games created
+// or edited at runtime live in the base class's hash and shadow the cached ones.
+
+struct GameDbCacheHeader;
 
 class AppGameDatabase : public BaseGameDatabaseImpl
 {
@@ -45,14 +53,36 @@ protected:
 	wxString		header;			// Header of the database
 	wxString		baseKey;		// Key to separate games by ("Serial")
 
+	const u8*		m_cache;		// mapped view of the compiled database, or NULL
+	size_t			m_cacheSize;
+
 public:
-	AppGameDatabase() {}
+	AppGameDatabase()
+	{
+		m_cache		= NULL;
+		m_cacheSize	= 0;
+	}
+
 	virtual ~AppGameDatabase() throw() {
 		Console.WriteLn( "(GameDB) Unloading..." );
+		HostSys::MunmapFile( (void*)m_cache, m_cacheSize );
 	}
 
 	AppGameDatabase& LoadFromFile(const wxString& file = Path::Combine( PathDefs::GetProgramDataDir(), wxFileName(L"GameIndex.dbf") ), const wxString& key = L"Serial" );
 	void SaveToFile(const wxString& file = Path::Combine( PathDefs::GetProgramDataDir(), wxFileName(L"GameIndex.dbf")) );
+
+	bool findGame(Game_Data& dest, const wxString& id);
+
+protected:
+	const GameDbCacheHeader& CacheHeader() const { return *(const GameDbCacheHeader*)m_cache; }
+
+	bool LoadCache(const wxString& cachefile, const wxString& source);
+	bool WriteCache(const wxString& cachefile, const wxString& source) const;
+	void UnloadCache();
+
+	bool findCachedGame(Game_Data& dest, const wxString& id) const;
+	bool DecodeCachedGame(u32 offset, Game_Data& dest) const;
+	bool DecodeCachedString(u32 offset, wxString& dest) const;
 };
 
 static wxString compatToStringWX(int compat) {
@@ -1054,6 +1054,9 @@ protected:
 		CoreThread.ResetQuick();
 		symbolMap.Clear();
 
+		// Snapshots of the previous VM are no use to the new one.
+		StateCopy_ClearSnapshots();
+
 		CDVDsys_SetFile( CDVDsrc_Iso, g_Conf->CurrentIso );
 		if( m_UseCDVDsrc )
 			CDVDsys_ChangeSource( m_cdvdsrc_type );
@@ -61,6 +61,11 @@ extern void StateCopy_LoadFromFile( const wxString& file );
 extern void StateCopy_SaveToSlot( uint num );
 extern void StateCopy_LoadFromSlot( uint slot, bool isFromBackup = false );
 
+extern void StateCopy_TakeSnapshot();
+extern void StateCopy_RestoreSnapshot( uint age = 0 );
+extern void StateCopy_ClearSnapshots();
+extern void StateCopy_VerifySnapshots();
+
 extern void States_registerLoadBackupMenuItem( wxMenuItem* loadBackupMenuItem );
 
 extern bool States_isSlotUsed(int num);
@@ -69,6 +74,9 @@ extern void States_DefrostCurrentSlot();
 extern void States_FreezeCurrentSlot();
 extern void States_CycleSlotForward();
 extern void States_CycleSlotBackward();
+extern void States_TakeSnapshot();
+extern void States_RestoreSnapshot();
+extern void States_RewindSnapshot();
 
 extern void States_SetCurrentSlot( int slot );
 extern int  States_GetCurrentSlot();
@@ -19,6 +19,7 @@
 #include "DebugTools/DebugInterface.h"
 #include "DebugTools/DisassemblyManager.h"
 #include "DebugTools/Breakpoints.h"
+#include "DebugTools/MIPSAnalyst.h"
 #include "BreakpointWindow.h"
 #include "PathDefs.h"
 
@@ -472,6 +473,18 @@ void DisassemblyDialog::onClose(wxCloseEvent& evt)
 	Hide();
 }
 
+// Hiding the debugger pauses the background function analysis; showing it resumes it, with
+// only the code that changed meanwhile to rescan.
+bool DisassemblyDialog::Show(bool show)
+{
+	if (show)
+		MIPSAnalyst::StartAnalysis();
+	else
+		MIPSAnalyst::StopAnalysis();
+
+	return wxFrame::Show(show);
+}
+
 void DisassemblyDialog::update()
 {
 	if (currentCpu != NULL)
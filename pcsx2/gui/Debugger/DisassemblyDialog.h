@@ -71,6 +71,7 @@ public:
 	static wxString GetNameStatic() { return L"DisassemblyDialog"; }
 	wxString GetDialogName() const { return GetNameStatic(); }
 	
+	bool Show(bool show = true);
 	void update();
 	void reset();
 	void setDebugMode(bool debugMode, bool switchPC);
@@ -21,6 +21,7 @@
 
 #include "GS.h"
 #include "MSWstuff.h"
+#include "CDVD/IsoSectorCache.h"
 
 #include <wx/utils.h>
 
@@ -42,6 +43,12 @@ void GSPanel::InitDefaultAccelerators()
 	m_Accels->Map( AAC( WXK_F3 ).Shift(),		"States_DefrostCurrentSlotBackup");
 	m_Accels->Map( AAC( WXK_F2 ),				"States_CycleSlotForward" );
 	m_Accels->Map( AAC( WXK_F2 ).Shift(),		"States_CycleSlotBackward" );
+	m_Accels->Map( AAC( WXK_F1 ).Cmd(),			"States_TakeSnapshot" );
+	m_Accels->Map( AAC( WXK_F3 ).Cmd(),			"States_RestoreSnapshot" );
+	m_Accels->Map( AAC( WXK_F3 ).Cmd().Shift(),	"States_RewindSnapshot" );
+#ifdef PCSX2_DEVBUILD
+	m_Accels->Map( AAC( WXK_F1 ).Cmd().Shift(),	"States_VerifySnapshots" );
+#endif
 
 	m_Accels->Map( AAC( WXK_F4 ),				"Framelimiter_MasterToggle");
 	m_Accels->Map( AAC( WXK_F4 ).Shift(),		"Frameskip_Toggle");
@@ -565,13 +572,22 @@ void GSFrame::OnUpdateTitle( wxTimerEvent& evt )
 		}
 	}
 
+	// Disc reads: how many sectors the prefetcher had ready in time, and how often the
+	// emulation had to wait for the image.
+	FastFormatUnicode isoStats;
+	IsoSectorCacheStats cache;
+	if (ISOgetCacheStats(cache) && cache.Requests) {
+		isoStats.Write(L" | ISO: %3u%% cached, %u stalls",
+			cache.GetHitPercent(), cache.Stalls);
+	}
+
 	const u64& smode2 = *(u64*)PS2GS_BASE(GS_SMODE2);
 
-	SetTitle( pxsFmt( L"%s | %ls (%ls) | Limiter: %ls | fps: %6.02f%ls | State %d",
+	SetTitle( pxsFmt( L"%s | %ls (%ls) | Limiter: %ls | fps: %6.02f%ls%ls | State %d",
 		WX_STR(fromUTF8(gsDest)),
 		(smode2 & 1) ? L"Interlaced" : L"Progressive",
 		(smode2 & 2) ? L"frame" : L"field",
-		limiterStr, fps, cpuUsage.c_str(), States_GetCurrentSlot() )
+		limiterStr, fps, cpuUsage.c_str(), isoStats.c_str(), States_GetCurrentSlot() )
 	);
 
 	//States_GetCurrentSlot()
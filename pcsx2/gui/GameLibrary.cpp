@@ -0,0 +1,464 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2010  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PrecompiledHeader.h"
+#include "App.h"
+#include "GameLibrary.h"
+#include "Elfheader.h"
+#include "CDVD/IsoFileFormats.h"
+#include "ZipTools/ThreadedZipTools.h"
+
+#include <wx/dir.h>
+#include <wx/ffile.h>
+
+// --------------------------------------------------------------------------------------
+//  IsoImageSectorSource
+// --------------------------------------------------------------------------------------
+// Reads the 2048 byte user data of the sectors of an image opened privately by the
+// scanner (the CDVD source the VM boots from is left alone).
+class IsoImageSectorSource : public SectorSource
+{
+protected:
+	InputIsoFile&	m_iso;
+	u8				m_buffer[CD_FRAMESIZE_RAW];
+
+public:
+	IsoImageSectorSource( InputIsoFile& iso )
+		: m_iso( iso )
+	{
+	}
+
+	virtual ~IsoImageSectorSource() throw() {}
+
+	int getNumSectors() { return m_iso.GetBlockCount(); }
+
+	bool readSector( unsigned char* buffer, int lba )
+	{
+		m_iso.BeginRead2( lba );
+		if( m_iso.FinishRead3( m_buffer, CDVD_MODE_2048 ) < 0 ) return false;
+
+		memcpy_fast( buffer, m_buffer, 2048 );
+		return true;
+	}
+
+	wxString getImagePath() { return m_iso.GetFilename(); }
+};
+
+// --------------------------------------------------------------------------------------
+//  Image scanning
+// --------------------------------------------------------------------------------------
+
+static bool GetImageStamp( const wxString& path, s64& time, u64& size )
+{
+	wxFileName fn( path );
+	if( !fn.FileExists() ) return false;
+
+	time = fn.GetModificationTime().GetValue().GetValue();
+	size = fn.GetSize().GetValue();
+	return true;
+}
+
+static bool IsoFileExists( const IsoDirectory& rootdir, const wxString& filename )
+{
+	try
+	{
+		rootdir.FindFile( filename );
+		return true;
+	}
+	catch( Exception::FileNotFound& )
+	{
+		return false;
+	}
+}
+
+// Same rules as the BIOS (and cdvdReloadElfInfo) use to find the boot ELF, minus the logging.
+static GameDiscType ReadSystemCnf( const IsoDirectory& rootdir, wxString& elfname )
+{
+	IsoFile file( rootdir, L"SYSTEM.CNF;1" );
+
+	GameDiscType type = GameDisc_Unknown;
+	while( !file.eof() )
+	{
+		const ParsedAssignmentString parts( fromUTF8(file.readLine().c_str()) );
+		if( parts.rvalue.IsEmpty() ) continue;
+
+		if( parts.lvalue == L"BOOT2" )
+		{
+			elfname = parts.rvalue;
+			type = GameDisc_PS2;
+		}
+		else if( parts.lvalue == L"BOOT" )
+		{
+			elfname = parts.rvalue;
+			type = GameDisc_PS1;
+		}
+	}
+	return type;
+}
+
+// Serials are derived from ELF names the same way cdvdReloadElfInfo does it
+// (SLUS_204.86 -> SLUS-20486).
+static wxString GetSerialFromElfName( const wxString& elfname )
+{
+	wxString fname( elfname.AfterLast('\\') );
+	if( !fname ) fname = elfname.AfterLast('/');
+	if( !fname ) fname = elfname.AfterLast(':');
+
+	if( !fname.Matches(L"????_???.??*") ) return wxEmptyString;
+	return fname(0,4) + L"-" + fname(5,3) + fname(9,2);
+}
+
+// Fills in everything but the path and file stamp.  Returns false if the image couldn't be
+// read; such results are not remembered, so the image gets another try on the next scan.
+static bool ScanImage( GameLibraryEntry& entry )
+{
+	try
+	{
+		ScopedPtr<InputIsoFile> iso( new InputIsoFile() );
+
+		// Not an image we can read at all (or not right now): nothing to remember.
+		if( !iso->Test( entry.Path ) ) return false;
+		iso->Open( entry.Path );
+
+		IsoImageSectorSource source( *iso );
+		IsoDirectory rootdir( source );
+
+		if( !IsoFileExists( rootdir, L"SYSTEM.CNF;1" ) )
+		{
+			if( IsoFileExists( rootdir, L"PSX.EXE;1" ) )
+				entry.Type = GameDisc_PS1;
+			else if( IsoFileExists( rootdir, L"VIDEO_TS/VIDEO_TS.IFO;1" ) )
+				entry.Type = GameDisc_DVDVideo;
+			return true;
+		}
+
+		entry.Type = ReadSystemCnf( rootdir, entry.ElfName );
+		entry.Serial = GetSerialFromElfName( entry.ElfName );
+		if( entry.Type != GameDisc_PS2 ) return true;
+
+		// The version suffix of BOOT2 is ignored, as in loadElf().
+		const wxString fixedname( wxStringTokenizer(entry.ElfName, L';').GetNextToken() + L";1" );
+
+		IsoFile elf( rootdir, fixedname );
+		entry.ElfCRC = ElfObject( fixedname, elf ).getCRC();
+		return true;
+	}
+	catch( Exception::FileNotFound& )
+	{
+		// No ISO9660 filesystem, or a SYSTEM.CNF pointing nowhere.
+		return true;
+	}
+	catch( BaseException& ex )
+	{
+		Console.Warning( L"(GameLibrary) Could not scan '%s': %s", WX_STR(entry.Path), WX_STR(ex.FormatDiagnosticMessage()) );
+		return false;
+	}
+	catch( std::runtime_error& ex )
+	{
+		Console.Warning( L"(GameLibrary) Could not scan '%s': %s", WX_STR(entry.Path), WX_STR(fromUTF8(ex.what())) );
+		return false;
+	}
+}
+
+class GameScanJobs : public ArchiveJobPool
+{
+protected:
+	std::vector<GameLibraryEntry>&	m_entries;
+	std::vector<u8>&				m_scanned;
+
+public:
+	GameScanJobs( std::vector<GameLibraryEntry>& entries, std::vector<u8>& scanned )
+		: m_entries( entries )
+		, m_scanned( scanned )
+	{
+	}
+
+	virtual ~GameScanJobs() throw() {}
+
+protected:
+	void DoJob( uint idx )
+	{
+		m_scanned[idx] = ScanImage( m_entries[idx] );
+	}
+};
+
+// --------------------------------------------------------------------------------------
+//  GameLibrary  (implementations)
+// --------------------------------------------------------------------------------------
+// The library file is a header followed by one record per image:
+//   string path, s64 time, u64 size, u32 type, string elfname, string serial, u32 crc
+// where strings are a u32 length followed by UTF-8 text.
+
+static const u32 GameLibraryMagic	= 0x42494c47;	// "GLIB"
+static const u32 GameLibraryVersion	= 1;
+
+GameLibrary::GameLibrary()
+	: m_filename( GetFilename() )
+{
+	m_dirty = false;
+}
+
+wxString GameLibrary::GetFilename()
+{
+	return GetCacheFolder().Combine( wxFileName(L"GameLibrary.dat") ).GetFullPath();
+}
+
+class GameLibraryReader
+{
+protected:
+	const u8*	m_pos;
+	const u8*	m_end;
+
+public:
+	GameLibraryReader( const u8* data, size_t size )
+	{
+		m_pos = data;
+		m_end = data + size;
+	}
+
+	bool IsEof() const { return m_pos == m_end; }
+
+	template< typename T >
+	bool Read( T& dest )
+	{
+		if( (size_t)(m_end - m_pos) < sizeof(T) ) return false;
+		memcpy( &dest, m_pos, sizeof(T) );
+		m_pos += sizeof(T);
+		return true;
+	}
+
+	bool ReadString( wxString& dest )
+	{
+		u32 length;
+		if( !Read( length ) || (size_t)(m_end - m_pos) < length ) return false;
+		dest = wxString::FromUTF8( (const char*)m_pos, length );
+		m_pos += length;
+		return true;
+	}
+};
+
+static void WriteString( std::vector<u8>& dest, const wxString& src )
+{
+	const wxCharBuffer utf8( src.ToUTF8() );
+	const u32 length = strlen( utf8.data() );
+
+	dest.insert( dest.end(), (const u8*)&length, (const u8*)&length + sizeof(length) );
+	dest.insert( dest.end(), (const u8*)utf8.data(), (const u8*)utf8.data() + length );
+}
+
+template< typename T >
+static void WriteValue( std::vector<u8>& dest, const T& src )
+{
+	dest.insert( dest.end(), (const u8*)&src, (const u8*)&src + sizeof(T) );
+}
+
+void GameLibrary::Load()
+{
+	m_entries.clear();
+	m_dirty = false;
+
+	wxFFile file( m_filename, L"rb" );
+	if( !file.IsOpened() ) return;
+
+	std::vector<u8> data( (size_t)file.Length() );
+	if( data.empty() || file.Read( &data[0], data.size() ) != data.size() ) return;
+
+	GameLibraryReader reader( &data[0], data.size() );
+
+	u32 magic, version, count;
+	if( !reader.Read( magic ) || !reader.Read( version ) || !reader.Read( count ) ) return;
+	if( magic != GameLibraryMagic || version != GameLibraryVersion ) return;
+
+	for( u32 i=0; i<count; ++i )
+	{
+		GameLibraryEntry entry;
+		u32 type;
+
+		bool ok = reader.ReadString( entry.Path ) && reader.Read( entry.Time ) && reader.Read( entry.Size )
+			&& reader.Read( type ) && reader.ReadString( entry.ElfName ) && reader.ReadString( entry.Serial )
+			&& reader.Read( entry.ElfCRC );
+
+		// A damaged library is simply rebuilt by the next scan.
+		if( !ok || type > GameDisc_DVDVideo )
+		{
+			m_entries.clear();
+			return;
+		}
+
+		entry.Type = (GameDiscType)type;
+		m_entries[entry.Path] = entry;
+	}
+}
+
+void GameLibrary::Save()
+{
+	if( !m_dirty ) return;
+
+	std::vector<u8> data;
+	WriteValue( data, GameLibraryMagic );
+	WriteValue( data, GameLibraryVersion );
+	WriteValue( data, (u32)m_entries.size() );
+
+	for( EntryMap::const_iterator it( m_entries.begin() ); it != m_entries.end(); ++it )
+	{
+		const GameLibraryEntry& entry( it->second );
+		WriteString( data, entry.Path );
+		WriteValue( data, entry.Time );
+		WriteValue( data, entry.Size );
+		WriteValue( data, (u32)entry.Type );
+		WriteString( data, entry.ElfName );
+		WriteString( data, entry.Serial );
+		WriteValue( data, entry.ElfCRC );
+	}
+
+	wxFileName( m_filename ).Mkdir( wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL );
+
+	const wxString filename( m_filename );
+	const wxString tmpfile( filename + L".tmp" );
+	{
+		wxFFile out( tmpfile, L"wb" );
+		if( out.IsOpened() && out.Write( &data[0], data.size() ) == data.size() && out.Close()
+			&& wxRenameFile( tmpfile, filename, true ) )
+		{
+			m_dirty = false;
+			return;
+		}
+	}
+
+	Console.Warning( L"(GameLibrary) Could not save the game library [%s]", WX_STR(filename) );
+	wxRemoveFile( tmpfile );
+}
+
+uint GameLibrary::Scan( const wxArrayString& images )
+{
+	std::vector<GameLibraryEntry> jobs;
+
+	for( uint i=0; i<images.GetCount(); ++i )
+	{
+		wxFileName fn( images[i] );
+		fn.MakeAbsolute();
+		const wxString path( fn.GetFullPath() );
+
+		GameLibraryEntry entry;
+		if( !GetImageStamp( path, entry.Time, entry.Size ) )
+		{
+			if( m_entries.erase( path ) ) m_dirty = true;
+			continue;
+		}
+
+		EntryMap::const_iterator it( m_entries.find( path ) );
+		if( it != m_entries.end() && it->second.Time == entry.Time && it->second.Size == entry.Size ) continue;
+
+		entry.Path = path;
+		jobs.push_back( entry );
+	}
+
+	if( jobs.empty() ) return 0;
+
+	u64 qpc_Start = GetCPUTicks();
+
+	std::vector<u8> scanned( jobs.size(), 0 );
+	GameScanJobs( jobs, scanned ).Run( jobs.size() );
+
+	for( uint i=0; i<jobs.size(); ++i )
+	{
+		// Images that couldn't be read are forgotten rather than kept with the results of
+		// an older version: they get another try on the next scan.
+		if( !scanned[i] )
+		{
+			if( m_entries.erase( jobs[i].Path ) ) m_dirty = true;
+			continue;
+		}
+
+		m_entries[jobs[i].Path] = jobs[i];
+		m_dirty = true;
+	}
+
+	u64 qpc_end = GetCPUTicks();
+	Console.WriteLn( "(GameLibrary) Scanned %u images in %ums", jobs.size(),
+		(u32)(((qpc_end-qpc_Start)*1000) / GetTickFrequency()) );
+
+	return jobs.size();
+}
+
+uint GameLibrary::ScanFolder( const wxDirName& folder, bool recursive )
+{
+	static const wxChar* imageTypes[] =
+	{
+		L"iso", L"mdf", L"nrg", L"bin", L"img", L"dump", L"gz", NULL
+	};
+
+	wxArrayString files, images;
+	if( folder.Exists() )
+		wxDir::GetAllFiles( folder.ToString(), &files, wxEmptyString, wxDIR_FILES | (recursive ? wxDIR_DIRS : 0) );
+
+	for( uint i=0; i<files.GetCount(); ++i )
+	{
+		const wxString ext( wxFileName(files[i]).GetExt().Lower() );
+		for( const wxChar** type = imageTypes; *type; ++type )
+		{
+			if( ext != *type ) continue;
+			images.Add( files[i] );
+			break;
+		}
+	}
+
+	// Forget the images that were in this folder but aren't anymore.
+	const wxString prefix( folder.ToString() );
+	for( EntryMap::iterator it( m_entries.begin() ); it != m_entries.end(); )
+	{
+		if( it->first.StartsWith( prefix ) && !wxFileExists( it->first ) )
+		{
+			m_entries.erase( it++ );
+			m_dirty = true;
+		}
+		else
+			++it;
+	}
+
+	return Scan( images );
+}
+
+const GameLibraryEntry* GameLibrary::Find( const wxString& image ) const
+{
+	wxFileName fn( image );
+	fn.MakeAbsolute();
+
+	EntryMap::const_iterator it( m_entries.find( fn.GetFullPath() ) );
+	return (it != m_entries.end()) ? &it->second : NULL;
+}
+
+uint GameLibrary::LogFolder( const wxDirName& folder ) const
+{
+	static const wxChar* typeNames[] = { L"Unknown", L"PS1", L"PS2", L"DVD" };
+
+	const wxString prefix( folder.ToString() );
+	uint count = 0;
+
+	for( EntryMap::const_iterator it( m_entries.begin() ); it != m_entries.end(); ++it )
+	{
+		if( !it->first.StartsWith( prefix ) ) continue;
+
+		const GameLibraryEntry& entry( it->second );
+		if( entry.Type == GameDisc_PS2 )
+			Console.WriteLn( L"  %-7s %-10s %08x  %s", typeNames[entry.Type], WX_STR(entry.Serial), entry.ElfCRC, WX_STR(entry.Path) );
+		else
+			Console.WriteLn( L"  %-7s %-10s %8s  %s", typeNames[entry.Type], WX_STR(entry.Serial), L"", WX_STR(entry.Path) );
+		++count;
+	}
+
+	Console.WriteLn( Color_StrongGreen, L"(GameLibrary) %u disc images in %s", count, WX_STR(prefix) );
+	return count;
+}
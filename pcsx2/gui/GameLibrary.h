@@ -0,0 +1,95 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2010  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "AppConfig.h"
+
+#include <map>
+
+enum GameDiscType
+{
+	GameDisc_Unknown = 0,		// not a disc image, or not a disc we recognize
+	GameDisc_PS1,
+	GameDisc_PS2,
+	GameDisc_DVDVideo,
+};
+
+// --------------------------------------------------------------------------------------
+//  GameLibraryEntry
+// --------------------------------------------------------------------------------------
+struct GameLibraryEntry
+{
+	wxString		Path;			// absolute path of the image
+	s64				Time;			// modification time of the image when it was scanned
+	u64				Size;			// ... and its size
+	GameDiscType	Type;
+	wxString		ElfName;		// BOOT2 (or BOOT) entry of SYSTEM.CNF
+	wxString		Serial;			// derived from the ELF name; empty if it doesn't follow the usual scheme
+	u32				ElfCRC;			// the game CRC the core reports for this disc (PS2 discs only)
+
+	GameLibraryEntry()
+	{
+		Time	= 0;
+		Size	= 0;
+		Type	= GameDisc_Unknown;
+		ElfCRC	= 0;
+	}
+};
+
+// --------------------------------------------------------------------------------------
+//  GameLibrary
+// --------------------------------------------------------------------------------------
+// Identifies disc images (type, ELF name, serial and CRC) several at a time, and remembers
+// the results in the cache folder.  Images whose size and modification time haven't changed
+// since they were last scanned are not opened again.  Directory walks go through each
+// image's IsoFSIndex, so even images that must be rescanned skip the directory reads when
+// they were booted or scanned before.
+//
+// The library itself is not thread safe; Scan() spreads the work over its own threads and
+// returns once all of it is done.
+//
+class GameLibrary
+{
+	DeclareNoncopyableObject( GameLibrary );
+
+public:
+	typedef std::map<wxString, GameLibraryEntry> EntryMap;
+
+protected:
+	wxString		m_filename;		// where the library is loaded from and saved to
+	EntryMap		m_entries;		// keyed by image path
+	bool			m_dirty;
+
+public:
+	GameLibrary();
+	virtual ~GameLibrary() throw() {}
+
+	void Load();
+	void Save();
+
+	// Returns the number of images that had to be (re)scanned.
+	uint Scan( const wxArrayString& images );
+	uint ScanFolder( const wxDirName& folder, bool recursive = true );
+
+	const GameLibraryEntry* Find( const wxString& image ) const;
+	const EntryMap& GetEntries() const { return m_entries; }
+
+	// Returns the number of images listed.
+	uint LogFolder( const wxDirName& folder ) const;
+
+protected:
+	static wxString GetFilename();
+};
@@ -411,6 +411,30 @@ static const GlobalCommandDescriptor CommandDeclarations[] =
 		pxL( "Cycles the current save slot in -1 fashion!" ),
 	},
 
+	{	"States_TakeSnapshot",
+		States_TakeSnapshot,
+		pxL( "Take snapshot" ),
+		pxL( "Keeps a copy of the virtual machine state in memory." ),
+	},
+
+	{	"States_RestoreSnapshot",
+		States_RestoreSnapshot,
+		pxL( "Restore snapshot" ),
+		pxL( "Restores the newest in-memory snapshot." ),
+	},
+
+	{	"States_RewindSnapshot",
+		States_RewindSnapshot,
+		pxL( "Rewind snapshot" ),
+		pxL( "Discards the newest in-memory snapshot and restores the one before it." ),
+	},
+
+	{	"States_VerifySnapshots",
+		StateCopy_VerifySnapshots,
+		NULL,
+		NULL,
+	},
+
 	{	"Frameskip_Toggle",
 		Implementations::Frameskip_Toggle,
 		NULL,
@@ -595,6 +619,9 @@ void Pcsx2App::InitDefaultGlobalAccelerators()
 	GlobalAccels->Map( AAC( WXK_F3 ),			"States_DefrostCurrentSlot" );
 	GlobalAccels->Map( AAC( WXK_F2 ),			"States_CycleSlotForward" );
 	GlobalAccels->Map( AAC( WXK_F2 ).Shift(),	"States_CycleSlotBackward" );
+	GlobalAccels->Map( AAC( WXK_F1 ).Cmd(),		"States_TakeSnapshot" );
+	GlobalAccels->Map( AAC( WXK_F3 ).Cmd(),		"States_RestoreSnapshot" );
+	GlobalAccels->Map( AAC( WXK_F3 ).Cmd().Shift(),	"States_RewindSnapshot" );
 
 	GlobalAccels->Map( AAC( WXK_F4 ),			"Framelimiter_MasterToggle");
 	GlobalAccels->Map( AAC( WXK_F4 ).Shift(),	"Frameskip_Toggle");
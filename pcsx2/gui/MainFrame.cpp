@@ -208,6 +208,7 @@ void MainEmuFrame::ConnectMenus()
 	ConnectMenu( MenuId_Boot_CDVD2,			Menu_BootCdvd2_Click );
 	ConnectMenu( MenuId_Boot_ELF,			Menu_OpenELF_Click );
 	ConnectMenu( MenuId_IsoBrowse,			Menu_IsoBrowse_Click );
+	ConnectMenu( MenuId_Cdvd_ScanGames,		Menu_ScanGames_Click );
 	ConnectMenu( MenuId_EnableBackupStates, Menu_EnableBackupStates_Click );
 	ConnectMenu( MenuId_EnablePatches,		Menu_EnablePatches_Click );
 	ConnectMenu( MenuId_EnableCheats,		Menu_EnableCheats_Click );
@@ -448,6 +449,7 @@ MainEmuFrame::MainEmuFrame(wxWindow* parent, const wxString& title)
 	//m_menuCDVD.AppendSeparator();
 	m_menuCDVD.Append( MenuId_IsoSelector,	_("Iso Selector"), &isoRecents );
 	m_menuCDVD.Append( GetPluginMenuId_Settings(PluginId_CDVD), _("Plugin Menu"), m_PluginMenuPacks[PluginId_CDVD] );
+	m_menuCDVD.Append( MenuId_Cdvd_ScanGames,	_("Scan for games..."),	_("Identifies the disc images in a folder and lists them in the console.") );
 
 	m_menuCDVD.AppendSeparator();
 	m_menuCDVD.Append( MenuId_Src_Iso,		_("Iso"),		_("Makes the specified ISO image the CDVD source."), wxITEM_RADIO );
@@ -20,6 +20,7 @@
 
 #include "MainFrame.h"
 #include "IsoDropTarget.h"
+#include "GameLibrary.h"
 
 #include "Dialogs/ModalPopups.h"
 #include "Dialogs/ConfigurationDialog.h"
@@ -406,6 +407,104 @@ void MainEmuFrame::Menu_IsoBrowse_Click( wxCommandEvent &event )
 }
 
 
+// --------------------------------------------------------------------------------------
+//  GameScanStatusEvent
+// --------------------------------------------------------------------------------------
+// Shows how a game scan is getting along in the main window's status bar.
+class GameScanStatusEvent : public pxActionEvent
+{
+	typedef pxActionEvent _parent;
+
+protected:
+	wxString	m_text;
+	bool		m_done;
+
+public:
+	virtual ~GameScanStatusEvent() throw() {}
+	GameScanStatusEvent* Clone() const { return new GameScanStatusEvent( *this ); }
+
+	GameScanStatusEvent( const wxString& text, bool done )
+		: m_text( text )
+	{
+		m_done = done;
+	}
+
+	GameScanStatusEvent( const GameScanStatusEvent& src )
+		: _parent( src )
+		, m_text( src.m_text )
+	{
+		m_done = src.m_done;
+	}
+
+protected:
+	void InvokeEvent()
+	{
+		MainEmuFrame* mainFrame = GetMainFramePtr();
+		if( mainFrame == NULL ) return;
+
+		mainFrame->SetStatusText( m_text );
+		if( m_done ) mainFrame->EnableMenuItem( MenuId_Cdvd_ScanGames, true );
+	}
+};
+
+// --------------------------------------------------------------------------------------
+//  SysExecEvent_ScanGames
+// --------------------------------------------------------------------------------------
+// Opening every image of a folder can take a while, so the scan runs on the executor thread
+// (which also keeps two scans from writing the library at the same time).
+class SysExecEvent_ScanGames : public SysExecEvent
+{
+protected:
+	wxDirName	m_folder;
+
+public:
+	wxString GetEventName() const { return L"ScanGames"; }
+
+	virtual ~SysExecEvent_ScanGames() throw() {}
+	SysExecEvent_ScanGames* Clone() const { return new SysExecEvent_ScanGames( *this ); }
+
+	SysExecEvent_ScanGames( const wxDirName& folder )
+		: m_folder( folder )
+	{
+	}
+
+protected:
+	void InvokeEvent()
+	{
+		wxGetApp().PostAction( GameScanStatusEvent( pxsFmt( _("Scanning for games in %s..."), WX_STR(m_folder.ToString()) ), false ) );
+
+		uint scanned = 0, found = 0;
+		try
+		{
+			GameLibrary library;
+			library.Load();
+			scanned = library.ScanFolder( m_folder );
+			library.Save();
+			found = library.LogFolder( m_folder );
+		}
+		catch( ... )
+		{
+			wxGetApp().PostAction( GameScanStatusEvent( _("Game scan failed."), true ) );
+			throw;
+		}
+
+		wxGetApp().PostAction( GameScanStatusEvent(
+			pxsFmt( _("Found %u disc images in %s (%u scanned)."), found, WX_STR(m_folder.ToString()), scanned ), true ) );
+	}
+};
+
+void MainEmuFrame::Menu_ScanGames_Click( wxCommandEvent &event )
+{
+	wxDirDialog ctrl( this, _("Select a folder with disc images..."), g_Conf->Folders.RunIso.ToString(),
+		wxDD_DEFAULT_STYLE | wxDD_DIR_MUST_EXIST );
+
+	if( ctrl.ShowModal() == wxID_CANCEL ) return;
+
+	// Re-enabled once the scan has posted its results.
+	EnableMenuItem( MenuId_Cdvd_ScanGames, false );
+	GetSysExecutorThread().PostEvent( new SysExecEvent_ScanGames( wxDirName( ctrl.GetPath() ) ) );
+}
+
 void MainEmuFrame::Menu_MultitapToggle_Click( wxCommandEvent& )
 {
 	g_Conf->EmuOptions.MultitapPort0_Enabled = GetMenuBar()->IsChecked( MenuId_Config_Multitap0Toggle );
@@ -33,6 +33,12 @@ struct Component_FileMcd;
 
 #include <wx/ffile.h>
 
+#ifdef __WXMSW__
+#	include <io.h>
+#else
+#	include <unistd.h>
+#endif
+
 static const int MCD_SIZE	= 1024 *  8  * 16;		// Legacy PSX card default size
 
 static const int MC2_MBSIZE	= 1024 * 528 * 2;		// Size of a single megabyte of card data
@@ -43,19 +49,41 @@ static const int MC2_SIZE	= MC2_MBSIZE * 8;		// PS2 card default size (8MB)
 // --------------------------------------------------------------------------------------
 // Provides thread-safe direct file IO mapping.
 //
+// Cards are loaded into memory when opened, and all accesses from the SIO are plain memory
+// copies.  Modified erase blocks are written back by a background thread every second (and
+// synced to the disk), and whatever is left is flushed when the cards are closed -- so save
+// heavy games don't stall the emulation on the disk, or worse, on network storage.
+//
+class FileMcdFlushThread;
+
 class FileMemoryCard
 {
+	friend class FileMcdFlushThread;
+
 protected:
+	// Write-back granularity: one erase block, data and ECC included.
+	static const uint FlushBlockSize	= 528 * 16;
+	static const int FlushInterval		= 1000;		// in milliseconds
+
 	wxFFile			m_file[8];
 	u8				m_effeffs[528*16];
-	SafeArray<u8>	m_currentdata;
 	u64				m_chksum[8];
 	bool			m_ispsx[8];
 	u32				m_chkaddr;
 
+	SafeArray<u8>	m_image[8];			// contents of the whole file
+	uint			m_offset[8];		// offset of the card data in the file (legacy PSX formats)
+	std::vector<u8>	m_dirty[8];			// dirty flag of each erase block of the image
+	uint			m_dirtycount[8];
+	bool			m_writeError[8];	// the last flush failed (only touched by Flush)
+
+	// Protects the images and dirty flags against the flush thread.
+	Mutex			m_lock;
+	ScopedPtr<FileMcdFlushThread>	m_flusher;
+
 public:
 	FileMemoryCard();
-	virtual ~FileMemoryCard() throw() {}
+	virtual ~FileMemoryCard() throw();
 
 	void Lock();
 	void Unlock();
@@ -71,8 +99,11 @@ public:
 	s32  EraseBlock	( uint slot, u32 adr );
 	u64  GetCRC		( uint slot );
 
+	void Flush();
+
 protected:
-	bool Seek( wxFFile& f, u32 adr );
+	u8* GetPtr( uint slot, u32 adr, int size );
+	void MarkDirty( uint slot, u32 adr, int size );
 	bool Create( const wxString& mcdFile, uint sizeInMB );
 
 	wxString GetDisabledMessage( uint slot ) const
@@ -83,6 +114,61 @@ protected:
 	}
 };
 
+// --------------------------------------------------------------------------------------
+//  FileMcdFlushThread
+// --------------------------------------------------------------------------------------
+class FileMcdFlushThread : public pxThread
+{
+	typedef pxThread _parent;
+
+protected:
+	FileMemoryCard&		m_mcd;
+	volatile bool		m_quit;
+
+public:
+	FileMcdFlushThread( FileMemoryCard& mcd )
+		: _parent( L"FileMcd Flush" )
+		, m_mcd( mcd )
+	{
+		m_quit = false;
+	}
+
+	virtual ~FileMcdFlushThread() throw()
+	{
+		_parent::Cancel();
+	}
+
+	// Not done through Cancel(), since cancelling the thread in the middle of a flush would
+	// lose the blocks it took off the dirty list.
+	void Stop()
+	{
+		m_quit = true;
+		m_sem_event.Post();
+		Block();
+	}
+
+protected:
+	void ExecuteTaskInThread()
+	{
+		while( !m_quit )
+		{
+			m_sem_event.WaitWithoutYield( wxTimeSpan( 0, 0, 0, FileMemoryCard::FlushInterval ) );
+			m_mcd.Flush();
+		}
+	}
+};
+
+// Commits the file's buffers to the disk.  Returns false if they may not have made it.
+static bool SyncFile( wxFFile& f )
+{
+	if( !f.Flush() ) return false;
+#ifdef __WXMSW__
+	return _commit( _fileno( f.fp() ) ) == 0;
+#else
+	return fsync( fileno( f.fp() ) ) == 0;
+#endif
+}
+
 uint FileMcd_GetMtapPort(uint slot)
 {
 	switch( slot )
@@ -139,12 +225,27 @@ wxString FileMcd_GetDefaultName(uint slot)
 FileMemoryCard::FileMemoryCard()
 {
 	memset8<0xff>( m_effeffs );
+	memzero( m_dirtycount );
+	memzero( m_writeError );
+	memzero( m_offset );
+	memzero( m_ispsx );
+}
+
+FileMemoryCard::~FileMemoryCard() throw()
+{
+	if( m_flusher ) m_flusher->Stop();
+	m_flusher = NULL;
 }
 
 void FileMemoryCard::Open()
 {
 	for( int slot=0; slot<8; ++slot )
 	{
+		m_image[slot].Dispose();
+		m_dirty[slot].clear();
+		m_dirtycount[slot] = 0;
+		m_writeError[slot] = false;
+
 		if( FileMcd_IsMultitapSlot(slot) )
 		{
 			if( !EmuConfig.MultitapPort0_Enabled && (FileMcd_GetMtapPort(slot) == 0) ) continue;
@@ -201,53 +302,185 @@ void FileMemoryCard::Open()
 				wxsFormat(_( "Access denied to memory card: \n\n%s\n\n" ), str.c_str()) +
 				GetDisabledMessage( slot )
 			);
+			continue;
 		}
-		else // Load checksum
+
+		const u32 size = m_file[slot].Length();
+
+		m_image[slot].ExactAlloc( size );
+		if( m_file[slot].Read( m_image[slot].GetPtr(), size ) != size )
 		{
-			m_ispsx[slot] = m_file[slot].Length() == 0x20000;
-			m_chkaddr = 0x210;
+			Msgbox::Alert(
+				wxsFormat(_( "Access denied to memory card: \n\n%s\n\n" ), str.c_str()) +
+				GetDisabledMessage( slot )
+			);
+			m_image[slot].Dispose();
+			m_file[slot].Close();
+			continue;
+		}
+
+		// If anyone knows why this filesize logic is here (it appears to be related to legacy PSX
+		// cards, perhaps hacked support for some special emulator-specific memcard formats that
+		// had header info?), then please replace this comment with something useful.  Thanks!  -- air
+
+		m_offset[slot] = 0;
+
+		if( size == MCD_SIZE + 64 )
+			m_offset[slot] = 64;
+		else if( size == MCD_SIZE + 3904 )
+			m_offset[slot] = 3904;
+
+		m_dirty[slot].resize( (size + FlushBlockSize - 1) / FlushBlockSize );
 
-			if(!m_ispsx[slot] && !!m_file[slot].Seek( m_chkaddr ))
-				m_file[slot].Read( &m_chksum[slot], 8 );
+		// Load checksum
+		m_ispsx[slot] = size == 0x20000;
+		m_chkaddr = 0x210;
+
+		if( !m_ispsx[slot] )
+		{
+			if( const u8* chk = GetPtr( slot, m_chkaddr, 8 ) )
+				memcpy( &m_chksum[slot], chk, 8 );
 		}
 	}
+
+	m_flusher = new FileMcdFlushThread( *this );
+	m_flusher->Start();
 }
 
 void FileMemoryCard::Close()
 {
+	if( m_flusher )
+	{
+		m_flusher->Stop();
+		m_flusher = NULL;
+	}
+
 	for( int slot=0; slot<8; ++slot )
 	{
 		if (m_file[slot].IsOpened()) {
 			// Store checksum
-			if(!m_ispsx[slot] && !!m_file[slot].Seek(  m_chkaddr ))
-				m_file[slot].Write( &m_chksum[slot], 8 );
+			if( !m_ispsx[slot] )
+			{
+				if( u8* chk = GetPtr( slot, m_chkaddr, 8 ) )
+				{
+					memcpy( chk, &m_chksum[slot], 8 );
+					MarkDirty( slot, m_chkaddr, 8 );
+				}
+			}
+		}
+	}
+
+	Flush();
 
+	for( int slot=0; slot<8; ++slot )
+	{
+		if (m_file[slot].IsOpened())
 			m_file[slot].Close();
+
+		m_image[slot].Dispose();
+	}
+}
+
+// Writes the erase blocks modified since the last flush back to the files, and commits them
+// to the disk.  The blocks are copied out under the lock, so the SIO only ever waits for a
+// memcpy, never for the disk.  If the write fails, the blocks go back on the dirty list and
+// the next flush tries again.
+void FileMemoryCard::Flush()
+{
+	SafeArray<u8> staging( L"FileMcd Staging" );
+	std::vector<u32> offsets;
+
+	for( int slot=0; slot<8; ++slot )
+	{
+		offsets.clear();
+
+		{
+			ScopedLock lock( m_lock );
+			if( !m_dirtycount[slot] ) continue;
+
+			staging.MakeRoomFor( m_dirtycount[slot] * FlushBlockSize );
+
+			const uint size = m_image[slot].GetSizeInBytes();
+			u8* dest = staging.GetPtr();
+
+			for( uint i=0; i<m_dirty[slot].size(); ++i )
+			{
+				if( !m_dirty[slot][i] ) continue;
+
+				const u32 offset = i * FlushBlockSize;
+				memcpy( dest, m_image[slot].GetPtr( offset ), std::min( (uint)FlushBlockSize, size - offset ) );
+				dest += FlushBlockSize;
+
+				offsets.push_back( offset );
+				m_dirty[slot][i] = 0;
+			}
+
+			m_dirtycount[slot] = 0;
 		}
+
+		const uint size = m_image[slot].GetSizeInBytes();
+		wxFFile& mcfp( m_file[slot] );
+		bool ok = true;
+
+		for( uint i=0; i<offsets.size(); ++i )
+		{
+			const uint len = std::min( (uint)FlushBlockSize, size - offsets[i] );
+			ok = ok && mcfp.Seek( offsets[i] ) && (mcfp.Write( staging.GetPtr( i * FlushBlockSize ), len ) == len);
+		}
+
+		// If anything failed, the commit included, none of the blocks are known to be on the
+		// disk: all of them go back on the dirty list.  (Blocks the SIO modified since they
+		// were copied out are on it already.)
+		ok = SyncFile( mcfp ) && ok;
+
+		if( !ok )
+		{
+			ScopedLock lock( m_lock );
+
+			for( uint i=0; i<offsets.size(); ++i )
+			{
+				const uint block = offsets[i] / FlushBlockSize;
+				if( m_dirty[slot][block] ) continue;
+
+				m_dirty[slot][block] = 1;
+				m_dirtycount[slot]++;
+			}
+		}
+
+		// Only reported once until a flush works again, since the flush thread retries every
+		// FlushInterval.
+		if( !ok && !m_writeError[slot] )
+			Console.Error( "(FileMcd) Error writing memory card data back to disk! (slot %d)", slot );
+		else if( ok && m_writeError[slot] )
+			Console.WriteLn( "(FileMcd) Memory card data written back to disk after all. (slot %d)", slot );
+
+		m_writeError[slot] = !ok;
 	}
 }
 
-// Returns FALSE if the seek failed (is outside the bounds of the file).
-bool FileMemoryCard::Seek( wxFFile& f, u32 adr )
+// Returns a pointer to the card data at the given address, or NULL if the access is outside
+// the bounds of the file.
+u8* FileMemoryCard::GetPtr( uint slot, u32 adr, int size )
 {
-	const u32 size = f.Length();
+	const uint offset = adr + m_offset[slot];
 
-	// If anyone knows why this filesize logic is here (it appears to be related to legacy PSX
-	// cards, perhaps hacked support for some special emulator-specific memcard formats that
-	// had header info?), then please replace this comment with something useful.  Thanks!  -- air
+	if( (size < 0) || (offset + size > (uint)m_image[slot].GetSizeInBytes()) ) return NULL;
+	return m_image[slot].GetPtr( offset );
+}
 
-	u32 offset = 0;
+// Must be called with m_lock held.
+void FileMemoryCard::MarkDirty( uint slot, u32 adr, int size )
+{
+	const uint offset = adr + m_offset[slot];
+	const uint last = (offset + size - 1) / FlushBlockSize;
 
-	if( size == MCD_SIZE + 64 )
-		offset = 64;
-	else if( size == MCD_SIZE + 3904 )
-		offset = 3904;
-	else
+	for( uint i=offset / FlushBlockSize; i<=last; ++i )
 	{
-		// perform sanity checks here?
-	}
+		if( m_dirty[slot][i] ) continue;
 
-	return f.Seek( adr + offset );
+		m_dirty[slot][i] = 1;
+		m_dirtycount[slot]++;
+	}
 }
 
 // returns FALSE if an error occurred (either permission denied or disk full)
@@ -280,7 +513,7 @@ void FileMemoryCard::GetSizeInfo( uint slot, PS2E_McdSizeInfo& outways )
 	outways.Xor						= 18;  // 0x12, XOR 02 00 00 10
 
 	if( pxAssert( m_file[slot].IsOpened() ) )
-		outways.McdSizeInSectors	= m_file[slot].Length() / (outways.SectorSize + outways.EraseBlockSizeInSectors);
+		outways.McdSizeInSectors	= m_image[slot].GetSizeInBytes() / (outways.SectorSize + outways.EraseBlockSizeInSectors);
 	else
 		outways.McdSizeInSectors	= 0x4000;
 
@@ -295,44 +528,46 @@ bool FileMemoryCard::IsPSX( uint slot )
 
 s32 FileMemoryCard::Read( uint slot, u8 *dest, u32 adr, int size )
 {
-	wxFFile& mcfp( m_file[slot] );
-	if( !mcfp.IsOpened() )
+	if( !m_file[slot].IsOpened() )
 	{
 		DevCon.Error( "(FileMcd) Ignoring attempted read from disabled slot." );
 		memset(dest, 0, size);
 		return 1;
 	}
-	if( !Seek(mcfp, adr) ) return 0;
-	return mcfp.Read( dest, size ) != 0;
+
+	ScopedLock lock( m_lock );
+
+	const u8* src = GetPtr( slot, adr, size );
+	if( !src ) return 0;
+
+	memcpy( dest, src, size );
+	return 1;
 }
 
 s32 FileMemoryCard::Save( uint slot, const u8 *src, u32 adr, int size )
 {
-	wxFFile& mcfp( m_file[slot] );
-
-	if( !mcfp.IsOpened() )
+	if( !m_file[slot].IsOpened() )
 	{
 		DevCon.Error( "(FileMcd) Ignoring attempted save/write to disabled slot." );
 		return 1;
 	}
 
+	ScopedLock lock( m_lock );
+
+	u8* dest = GetPtr( slot, adr, size );
+	if( !dest ) return 0;
+
 	if(m_ispsx[slot])
 	{
-		m_currentdata.MakeRoomFor( size );
-		for (int i=0; i<size; i++) m_currentdata[i] = src[i];
+		memcpy( dest, src, size );
 	}
 	else
 	{
-		if( !Seek(mcfp, adr) ) return 0;
-		m_currentdata.MakeRoomFor( size );
-		mcfp.Read( m_currentdata.GetPtr(), size);
-		
-
 		for (int i=0; i<size; i++)
 		{
-			if ((m_currentdata[i] & src[i]) != src[i])
+			if ((dest[i] & src[i]) != src[i])
 				Console.Warning("(FileMcd) Warning: writing to uncleared data. (%d) [%08X]", slot, adr);
-			m_currentdata[i] &= src[i];
+			dest[i] &= src[i];
 		}
 
 		// Checksumness
@@ -340,7 +575,7 @@ s32 FileMemoryCard::Save( uint slot, const u8 *src, u32 adr, int size )
 			if(adr == m_chkaddr) 
 				Console.Warning("(FileMcd) Warning: checksum sector overwritten. (%d)", slot);
 
-			u64 *pdata = (u64*)&m_currentdata[0];
+			u64 *pdata = (u64*)dest;
 			u32 loops = size / 8;
 
 			for(u32 i = 0; i < loops; i++)
@@ -348,46 +583,45 @@ s32 FileMemoryCard::Save( uint slot, const u8 *src, u32 adr, int size )
 		}
 	}
 
-	if( !Seek(mcfp, adr) ) return 0;
-	return mcfp.Write( m_currentdata.GetPtr(), size ) != 0;
+	MarkDirty( slot, adr, size );
+	return 1;
 }
 
 s32 FileMemoryCard::EraseBlock( uint slot, u32 adr )
 {
-	wxFFile& mcfp( m_file[slot] );
-
-	if( !mcfp.IsOpened() )
+	if( !m_file[slot].IsOpened() )
 	{
 		DevCon.Error( "MemoryCard: Ignoring erase for disabled slot." );
 		return 1;
 	}
 
-	if( !Seek(mcfp, adr) ) return 0;
-	return mcfp.Write( m_effeffs, sizeof(m_effeffs) ) != 0;
+	ScopedLock lock( m_lock );
+
+	u8* dest = GetPtr( slot, adr, sizeof(m_effeffs) );
+	if( !dest ) return 0;
+
+	memcpy( dest, m_effeffs, sizeof(m_effeffs) );
+	MarkDirty( slot, adr, sizeof(m_effeffs) );
+	return 1;
 }
 
 u64 FileMemoryCard::GetCRC( uint slot )
 {
-	wxFFile& mcfp( m_file[slot] );
-	if( !mcfp.IsOpened() ) return 0;
+	if( !m_file[slot].IsOpened() ) return 0;
 
 	u64 retval = 0;
 
 	if(m_ispsx[slot])
 	{
-		if( !Seek( mcfp, 0 ) ) return 0;
-
-		// Process the file in 4k chunks.  Speeds things up significantly.
-	
-		u64 buffer[528*8];		// use 528 (sector size), ensures even divisibility
-	
-		const uint filesize = mcfp.Length() / sizeof(buffer);
-		for( uint i=filesize; i; --i )
-		{
-			mcfp.Read( &buffer, sizeof(buffer) );
-			for( uint t=0; t<ArraySize(buffer); ++t )
-				retval ^= buffer[t];
-		}
+		ScopedLock lock( m_lock );
+
+		// Whole 528*8*8 byte chunks only, like the original file based version.
+		const uint chunk = 528*8*sizeof(u64);
+		const uint size = (m_image[slot].GetSizeInBytes() - m_offset[slot]) / chunk * chunk;
+		const u64* src = (const u64*)m_image[slot].GetPtr( m_offset[slot] );
+
+		for( uint i=0; i<size/sizeof(u64); ++i )
+			retval ^= src[i];
 	}
 	else
 	{
@@ -118,6 +118,49 @@ void States_DefrostCurrentSlotBackup()
 	_States_DefrostCurrentSlot( true );
 }
 
+// In-memory snapshots (see VmStateSnapshots): nothing is compressed or written to disk, only
+// the main memory pages written since the previous snapshot are copied, and they're lost on
+// shutdown.  Rewinding drops the newest snapshot and goes back to the one before it.
+void States_TakeSnapshot()
+{
+	if( !SysHasValidState() )
+	{
+		Console.WriteLn( "Take snapshot: Aborting (VM is not active)." );
+		return;
+	}
+
+	Console.WriteLn( Color_StrongGreen, "Taking in-memory snapshot..." );
+	StateCopy_TakeSnapshot();
+}
+
+static void _States_RestoreSnapshot( uint age )
+{
+	if( !SysHasValidState() )
+	{
+		Console.WriteLn( "Restore snapshot: Aborting (VM is not active)." );
+		return;
+	}
+
+	if( wxGetApp().HasPendingSaves() || IsSavingOrLoading )
+	{
+		Console.WriteLn( "Load or save action is already pending." );
+		return;
+	}
+
+	Console.WriteLn( Color_StrongGreen, age ? "Rewinding to the previous in-memory snapshot..." : "Restoring in-memory snapshot..." );
+	StateCopy_RestoreSnapshot( age );
+}
+
+void States_RestoreSnapshot()
+{
+	_States_RestoreSnapshot( 0 );
+}
+
+void States_RewindSnapshot()
+{
+	_States_RestoreSnapshot( 1 );
+}
+
 
 void States_registerLoadBackupMenuItem( wxMenuItem* loadBackupMenuItem )
 {
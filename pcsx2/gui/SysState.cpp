@@ -25,6 +25,7 @@
 #include "Utilities/pxStreams.h"
 
 #include <wx/wfstream.h>
+#include <wx/mstream.h>
 
 // Used to hold the current state backup (fullcopy of PS2 memory and plugin states).
 //static VmStateBuffer state_buffer( L"Public Savestate Buffer" );
@@ -148,6 +149,7 @@ public:
 	virtual void FreezeIn( pxInputStream& reader ) const
 	{
 		SysClearExecutionCache();
+		mmap_StopDirtyRamPages();
 		MemorySavestateEntry::FreezeIn( reader );
 	}
 };
@@ -326,6 +328,14 @@ protected:
 				.SetUserMsg(_("There is no active virtual machine state to download or save." ));
 
 		memSavingState saveme( m_dest_list->GetBuffer() );
+
+		u32 version = g_SaveVersion;
+		m_dest_list->Add( ArchiveEntry( EntryFilename_StateVersion )
+			.SetDataIndex( saveme.GetCurrentPos() )
+			.SetDataSize( sizeof(version) )
+		);
+		saveme.Freeze( version );
+
 		ArchiveEntry internals( EntryFilename_InternalStructures );
 		internals.SetDataIndex( saveme.GetCurrentPos() );
 
@@ -436,28 +446,9 @@ protected:
 
 		pxYield(4);
 
-		// Write the version and screenshot:
-		ScopedPtr<pxOutputStream> out( new pxOutputStream(tempfile, new wxZipOutputStream(woot)) );
-		wxZipOutputStream* gzfp = (wxZipOutputStream*)out->GetWxStreamBase();
-
-		{
-			wxZipEntry* vent = new wxZipEntry(EntryFilename_StateVersion);
-			vent->SetMethod( wxZIP_METHOD_STORE );
-			gzfp->PutNextEntry( vent );
-			out->Write(g_SaveVersion);
-			gzfp->CloseEntry();
-		}
-
-		ScopedPtr<wxImage> m_screenshot;
-		
-		if (m_screenshot)
-		{
-			wxZipEntry* vent = new wxZipEntry(EntryFilename_Screenshot);
-			vent->SetMethod( wxZIP_METHOD_STORE );
-			gzfp->PutNextEntry( vent );
-			m_screenshot->SaveFile( *gzfp, wxBITMAP_TYPE_JPEG );
-			gzfp->CloseEntry();
-		}
+		// The compress thread writes the zip archive itself (the version is one of the
+		// entries of the list), so it only needs the raw file stream.
+		ScopedPtr<pxOutputStream> out( new pxOutputStream(tempfile, woot) );
 
 		(*new VmStateCompressThread())
 			.SetSource(elist)
@@ -475,6 +466,40 @@ protected:
 	}
 };
 
+// --------------------------------------------------------------------------------------
+//  UnzipJobs
+// --------------------------------------------------------------------------------------
+// Decompresses the savestate entries (and the internal structures, as the last job) in
+// parallel.  Entries missing from the archive are left empty.
+//
+class UnzipJobs : public ArchiveJobPool
+{
+protected:
+	const ZipArchiveReader&		m_archive;
+	const int*					m_entries;
+	int							m_internal;
+	VmStateBuffer*				m_dest;
+
+public:
+	UnzipJobs( const ZipArchiveReader& archive, const int* entries, int internal, VmStateBuffer* dest )
+		: m_archive( archive )
+	{
+		m_entries	= entries;
+		m_internal	= internal;
+		m_dest		= dest;
+	}
+
+	virtual ~UnzipJobs() throw() {}
+
+protected:
+	void DoJob( uint idx )
+	{
+		const int member = (idx < NumSavestateEntries) ? m_entries[idx] : m_internal;
+		if (member >= 0)
+			m_archive.Extract( member, m_dest[idx] );
+	}
+};
+
 // --------------------------------------------------------------------------------------
 //  SysExecEvent_UnzipFromDisk
 // --------------------------------------------------------------------------------------
@@ -504,87 +529,56 @@ protected:
 	{
 		ScopedLock lock( mtx_CompressToDisk );
 
-		// Ugh.  Exception handling made crappy because wxWidgets classes don't support scoped pointers yet.
-
-		ScopedPtr<wxFFileInputStream> woot( new wxFFileInputStream(m_filename) );
-		if (!woot->IsOk())
-			throw Exception::CannotCreateStream( m_filename ).SetDiagMsg(L"Cannot open file for reading.");
-
-		ScopedPtr<pxInputStream> reader( new pxInputStream(m_filename, new wxZipInputStream(woot)) );
-		woot.DetachPtr();
+		ZipArchiveReader archive( m_filename );
 
-		if (!reader->IsOk())
+		if (!archive.IsOk())
 		{
 			throw Exception::SaveStateLoadError( m_filename )
 				.SetDiagMsg( L"Savestate file is not a valid gzip archive." )
 				.SetUserMsg(_("This savestate cannot be loaded because it is not a valid gzip archive.  It may have been created by an older unsupported version of PCSX2, or it may be corrupted."));
 		}
 
-		wxZipInputStream* gzreader = (wxZipInputStream*)reader->GetWxStreamBase();
-
-		// look for version and screenshot information in the zip stream:
-
-		bool foundVersion = false;
-		//bool foundScreenshot = false;
-		//bool foundEntry[numSavestateEntries] = false;
-
-		ScopedPtr<wxZipEntry> foundInternal;
-		ScopedPtr<wxZipEntry> foundEntry[NumSavestateEntries];
-
-		while(true)
-		{
-			Threading::pxTestCancel();
-
-			ScopedPtr<wxZipEntry> entry( gzreader->GetNextEntry() );
-			if (!entry) break;
-
-			if (entry->GetName().CmpNoCase(EntryFilename_StateVersion) == 0)
-			{
-				DevCon.WriteLn( Color_Green, L" ... found '%s'", EntryFilename_StateVersion);
-				foundVersion = true;
-				CheckVersion(*reader);
-				continue;
-			}
-
-			if (entry->GetName().CmpNoCase(EntryFilename_InternalStructures) == 0)
-			{
-				DevCon.WriteLn( Color_Green, L" ... found '%s'", EntryFilename_InternalStructures);
-				foundInternal = entry.DetachPtr();
-				continue;
-			}
+		// look for version and internal structures in the archive:
 
-			// No point in finding screenshots when loading states -- the screenshots are
-			// only useful for the UI savestate browser.
-			/*if (entry->GetName().CmpNoCase(EntryFilename_Screenshot) == 0)
-			{
-				foundScreenshot = true;
-			}*/
+		const int foundVersion	= archive.Find( EntryFilename_StateVersion );
+		const int foundInternal	= archive.Find( EntryFilename_InternalStructures );
 
-			for (uint i=0; i<NumSavestateEntries; ++i)
-			{
-				if (entry->GetName().CmpNoCase(SavestateEntries[i]->GetFilename()) == 0)
-				{
-					DevCon.WriteLn( Color_Green, L" ... found '%s'", WX_STR(SavestateEntries[i]->GetFilename()) );
-					foundEntry[i] = entry.DetachPtr();
-					break;
-				}
-			}
-		}
+		// No point in finding screenshots when loading states -- the screenshots are
+		// only useful for the UI savestate browser.
 
-		if (!foundVersion || !foundInternal)
+		if (foundVersion < 0 || foundInternal < 0)
 		{
 			throw Exception::SaveStateLoadError( m_filename )
 				.SetDiagMsg( pxsFmt(L"Savestate file does not contain '%s'",
-					!foundVersion ? EntryFilename_StateVersion : EntryFilename_InternalStructures) )
+					(foundVersion < 0) ? EntryFilename_StateVersion : EntryFilename_InternalStructures) )
 				.SetUserMsg(_("This file is not a valid PCSX2 savestate.  See the logfile for details."));
 		}
 
+		DevCon.WriteLn( Color_Green, L" ... found '%s'", EntryFilename_StateVersion);
+		DevCon.WriteLn( Color_Green, L" ... found '%s'", EntryFilename_InternalStructures);
+
+		{
+			VmStateBuffer version( L"StateBuffer_Version" );
+			archive.Extract( foundVersion, version );
+
+			pxInputStream reader( m_filename, new wxMemoryInputStream( version.GetPtr(), archive[foundVersion].Size ) );
+			CheckVersion( reader );
+		}
+
 		// Log any parts and pieces that are missing, and then generate an exception.
+		int foundEntry[NumSavestateEntries];
 		bool throwIt = false;
+
 		for (uint i=0; i<NumSavestateEntries; ++i)
 		{
-			if (foundEntry[i]) continue;
-			
+			foundEntry[i] = archive.Find( SavestateEntries[i]->GetFilename() );
+
+			if (foundEntry[i] >= 0)
+			{
+				DevCon.WriteLn( Color_Green, L" ... found '%s'", WX_STR(SavestateEntries[i]->GetFilename()) );
+				continue;
+			}
+
 			if (SavestateEntries[i]->IsRequired())
 			{
 				throwIt = true;
@@ -597,6 +591,12 @@ protected:
 				.SetDiagMsg( L"Savestate cannot be loaded: some required components were not found or are incomplete." )
 				.SetUserMsg(_("This savestate cannot be loaded due to missing critical components.  See the log file for details."));
 
+		// Decompress everything in parallel before touching the VM, so a corrupted archive
+		// can't leave it half loaded.
+
+		ScopedArray<VmStateBuffer> buffers( NumSavestateEntries + 1 );
+		UnzipJobs( archive, foundEntry, foundInternal, buffers.GetPtr() ).Run( NumSavestateEntries + 1 );
+
 		// We use direct Suspend/Resume control here, since it's desirable that emulation
 		// *ALWAYS* start execution after the new savestate is loaded.
 
@@ -605,23 +605,484 @@ protected:
 
 		for (uint i=0; i<NumSavestateEntries; ++i)
 		{
-			if (!foundEntry[i]) continue;
+			if (foundEntry[i] < 0) continue;
 
 			Threading::pxTestCancel();
 
-			gzreader->OpenEntry( *foundEntry[i] );
-			SavestateEntries[i]->FreezeIn( *reader );
+			pxInputStream reader( m_filename, new wxMemoryInputStream( buffers[i].GetPtr(), archive[foundEntry[i]].Size ) );
+			SavestateEntries[i]->FreezeIn( reader );
 		}
 
 		// Load all the internal data
 
-		gzreader->OpenEntry( *foundInternal );
+		memLoadingState( buffers[NumSavestateEntries] ).FreezeBios().FreezeInternals();
+		GetCoreThread().Resume();	// force resume regardless of emulation state earlier.
+	}
+};
+
+// --------------------------------------------------------------------------------------
+//  VmStateSnapshots
+// --------------------------------------------------------------------------------------
+// In-memory snapshots, meant for frequent autosaves and rewinding.  Only the newest snapshot
+// is kept in full; every older one is stored as the 4k pages that changed since, together
+// with their old contents (restoring walks the deltas backwards from the newest state).
+//
+// Main memory (32 megs, most of the state) is kept apart from the serialized state, and only
+// the pages written since the previous snapshot are looked at: the page fault handler tracks
+// them by write protecting main memory after every snapshot (see mmap_ResetDirtyRamPages).
+// Everything else (the other memories, the internal structures and the plugins) is still
+// frozen and compared in full each time, and there is one page fault per page that's written.
+//
+// All methods must be called with the core thread paused.
+//
+class VmStateSnapshots
+{
+	DeclareNoncopyableObject( VmStateSnapshots );
+
+public:
+	static const uint MaxSnapshots		= 32;
+	static const uint PageSize			= __pagesize;
 
-		VmStateBuffer buffer( foundInternal->GetSize(), L"StateBuffer_UnzipFromDisk" );		// start with an 8 meg buffer to avoid frequent reallocation.
-		reader->Read( buffer.GetPtr(), foundInternal->GetSize() );
+protected:
+	// Start offset of the internal structures and of every savestate entry in the serialized
+	// state, plus the end offset.
+	static const uint NumOffsets		= NumSavestateEntries + 2;
 
-		memLoadingState( buffer ).FreezeBios().FreezeInternals();
-		GetCoreThread().Resume();	// force resume regardless of emulation state earlier.
+	// The savestate entry of main memory (SavestateEntry_EmotionMemory), which is left empty
+	// in the serialized state.
+	static const uint RamEntry			= 0;
+	static const uint NumRamPages		= Ps2MemSize::MainRam / PageSize;
+
+	struct Delta
+	{
+		uint				Size;
+		uint				Offsets[NumOffsets];
+		std::vector<u32>	Pages;
+		std::vector<u8>		Data;
+
+		// Main memory pages, and their old contents.
+		std::vector<u32>	RamPages;
+		std::vector<u8>		RamData;
+	};
+
+	// The newest snapshot, and a scratch buffer for the next one (the two swap roles each
+	// time a snapshot is taken, so neither is ever reallocated from scratch).
+	VmStateBuffer		m_buffer[2];
+	uint				m_cur;
+	uint				m_size;
+	uint				m_offsets[NumOffsets];
+
+	// Main memory of the newest snapshot.
+	VmStateBuffer		m_ram;
+
+	// Deltas that turn the newest snapshot back into older ones, oldest first.
+	std::vector<Delta*>	m_deltas;
+
+public:
+	VmStateSnapshots()
+	{
+		m_cur	= 0;
+		m_size	= 0;
+	}
+
+	virtual ~VmStateSnapshots() throw()
+	{
+		Clear();
+	}
+
+	uint GetCount() const
+	{
+		return m_size ? (m_deltas.size() + 1) : 0;
+	}
+
+	void Clear();
+	void Take();
+	void Restore( uint age );
+
+	bool Verify();
+
+protected:
+	void TakeRam( Delta* delta );
+	void ApplyRamDelta( const Delta& delta );
+
+	static void MakeDelta( Delta& delta, const VmStateBuffer& prev, uint prevsize, const VmStateBuffer& next, uint size );
+	static void ApplyDelta( VmStateBuffer& state, const Delta& delta );
+	static bool VerifyDeltas();
+};
+
+// Keeps the pages of prev (prevsize bytes long) that differ in next, or that next doesn't
+// cover at all.
+void VmStateSnapshots::MakeDelta( Delta& delta, const VmStateBuffer& prev, uint prevsize, const VmStateBuffer& next, uint size )
+{
+	delta.Size = prevsize;
+	delta.Pages.clear();
+	delta.Data.clear();
+
+	for (uint offset=0; offset<prevsize; offset+=PageSize)
+	{
+		const uint len = std::min( (uint)PageSize, prevsize - offset );
+
+		if ((offset + len > size) || (memcmp( prev.GetPtr(offset), next.GetPtr(offset), len ) != 0))
+		{
+			delta.Pages.push_back( offset / PageSize );
+			delta.Data.insert( delta.Data.end(), prev.GetPtr(offset), prev.GetPtr(offset) + len );
+		}
+	}
+}
+
+// Turns the state a delta was made against back into the older one (delta.Size bytes long).
+void VmStateSnapshots::ApplyDelta( VmStateBuffer& state, const Delta& delta )
+{
+	state.MakeRoomFor( delta.Size );
+
+	const u8* src = delta.Data.data();
+
+	for (uint p=0; p<delta.Pages.size(); ++p)
+	{
+		const uint offset	= delta.Pages[p] * PageSize;
+		const uint len		= std::min( (uint)PageSize, delta.Size - offset );
+
+		memcpy( state.GetPtr(offset), src, len );
+		src += len;
+	}
+}
+
+// Brings m_ram up to date with main memory, keeping the old contents of the pages that
+// changed in the delta.  Without a delta (the first snapshot) all of main memory is copied.
+void VmStateSnapshots::TakeRam( Delta* delta )
+{
+	if (!delta)
+	{
+		m_ram.MakeRoomFor( Ps2MemSize::MainRam );
+		memcpy( m_ram.GetPtr(), eeMem->Main, Ps2MemSize::MainRam );
+		return;
+	}
+
+	for (uint page=0; page<NumRamPages; ++page)
+	{
+		if (!mmap_IsDirtyRamPage( page )) continue;
+
+		u8* saved		= m_ram.GetPtr( page * PageSize );
+		const u8* cur	= &eeMem->Main[page * PageSize];
+
+		if (memcmp( saved, cur, PageSize ) == 0) continue;
+
+		delta->RamPages.push_back( page );
+		delta->RamData.insert( delta->RamData.end(), saved, saved + PageSize );
+		memcpy( saved, cur, PageSize );
+	}
+}
+
+void VmStateSnapshots::ApplyRamDelta( const Delta& delta )
+{
+	const u8* src = delta.RamData.data();
+
+	for (uint p=0; p<delta.RamPages.size(); ++p)
+	{
+		memcpy( m_ram.GetPtr( delta.RamPages[p] * PageSize ), src, PageSize );
+		src += PageSize;
+	}
+}
+
+void VmStateSnapshots::Clear()
+{
+	for (uint i=0; i<m_deltas.size(); ++i)
+		delete m_deltas[i];
+
+	m_deltas.clear();
+	m_size = 0;
+}
+
+void VmStateSnapshots::Take()
+{
+	VmStateBuffer& prev	= m_buffer[m_cur];
+	VmStateBuffer& next	= m_buffer[m_cur ^ 1];
+	uint offsets[NumOffsets];
+
+	memSavingState saveme( next );
+
+	offsets[0] = saveme.GetCurrentPos();
+	saveme.FreezeBios();
+	saveme.FreezeInternals();
+
+	for (uint i=0; i<SavestateEntries.GetSize(); ++i)
+	{
+		offsets[i+1] = saveme.GetCurrentPos();
+
+		// Main memory goes to m_ram instead.
+		if (i != RamEntry)
+			SavestateEntries[i]->FreezeOut( saveme );
+	}
+
+	offsets[NumOffsets-1] = saveme.GetCurrentPos();
+	const uint size = saveme.GetCurrentPos();
+
+	ScopedPtr<Delta> delta;
+
+	if (m_size)
+	{
+		// Keep the pages of the previous snapshot that this one overwrites.
+
+		delta = new Delta;
+
+		MakeDelta( *delta, prev, m_size, next, size );
+		memcpy( delta->Offsets, m_offsets, sizeof(m_offsets) );
+	}
+
+	TakeRam( delta );
+
+	// Main memory is clean again, compared to m_ram.
+	mmap_ResetDirtyRamPages();
+
+	if (delta)
+	{
+		m_deltas.push_back( delta.DetachPtr() );
+
+		if (m_deltas.size() >= MaxSnapshots)
+		{
+			delete m_deltas.front();
+			m_deltas.erase( m_deltas.begin() );
+		}
+	}
+
+	m_cur ^= 1;
+	m_size = size;
+	memcpy( m_offsets, offsets, sizeof(offsets) );
+}
+
+// Loads the snapshot taken 'age' snapshots ago (0 being the newest), and discards all the
+// snapshots newer than it.
+void VmStateSnapshots::Restore( uint age )
+{
+	pxAssertDev( age < GetCount(), "Restoring a snapshot that doesn't exist!" );
+
+	VmStateBuffer& state = m_buffer[m_cur];
+
+	for (uint i=0; i<age; ++i)
+	{
+		ScopedPtr<Delta> delta( m_deltas.back() );
+		m_deltas.pop_back();
+
+		ApplyDelta( state, *delta );
+		ApplyRamDelta( *delta );
+
+		m_size = delta->Size;
+		memcpy( m_offsets, delta->Offsets, sizeof(m_offsets) );
+	}
+
+	SysClearExecutionCache();
+
+	// This isn't the core thread, so main memory can't be written to while it's protected.
+	mmap_StopDirtyRamPages();
+	memcpy( eeMem->Main, m_ram.GetPtr(), Ps2MemSize::MainRam );
+
+	for (uint i=0; i<SavestateEntries.GetSize(); ++i)
+	{
+		const uint start	= m_offsets[i+1];
+		const uint len		= m_offsets[i+2] - start;
+
+		// Plugins that don't support savestates (and main memory) have nothing to load.
+		if (!len) continue;
+
+		pxInputStream reader( SavestateEntries[i]->GetFilename(), new wxMemoryInputStream( state.GetPtr(start), len ) );
+		SavestateEntries[i]->FreezeIn( reader );
+	}
+
+	// The internal structures are always the start of the state.
+	memLoadingState( state ).FreezeBios().FreezeInternals();
+
+	mmap_ResetDirtyRamPages();
+}
+
+// Round trip of the deltas on made up states: changed pages, and states growing and shrinking
+// by odd sizes.
+bool VmStateSnapshots::VerifyDeltas()
+{
+	static const uint sizes[][2] =
+	{
+		{ 64 * PageSize,		64 * PageSize },
+		{ 64 * PageSize + 100,	70 * PageSize + 7 },
+		{ 70 * PageSize + 7,	64 * PageSize + 100 },
+		{ 100,					3 * PageSize },
+	};
+
+	VmStateBuffer older( L"Snapshot Check (older)" );
+	VmStateBuffer newer( L"Snapshot Check (newer)" );
+	Delta delta;
+
+	u32 seed = 0x9e3779b9;
+
+	for (uint i=0; i<ArraySize(sizes); ++i)
+	{
+		const uint oldsize = sizes[i][0];
+		const uint newsize = sizes[i][1];
+
+		older.MakeRoomFor( oldsize );
+		newer.MakeRoomFor( std::max( oldsize, newsize ) );
+
+		for (uint b=0; b<oldsize; ++b)
+		{
+			seed = seed * 1664525 + 1013904223;
+			*older.GetPtr(b) = (u8)(seed >> 24);
+		}
+
+		// The newer state starts out as the older one, then every third page changes a byte.
+		memcpy( newer.GetPtr(), older.GetPtr(), std::min( oldsize, newsize ) );
+		for (uint b=oldsize; b<newsize; ++b)
+			*newer.GetPtr(b) = (u8)b;
+		for (uint b=PageSize/2; b<newsize; b+=3*PageSize)
+			*newer.GetPtr(b) ^= 0x80;
+
+		MakeDelta( delta, older, oldsize, newer, newsize );
+		ApplyDelta( newer, delta );
+
+		if (memcmp( newer.GetPtr(), older.GetPtr(), oldsize ) != 0)
+		{
+			Console.Error( L"(Snapshots) Delta check failed: %u bytes restored from %u bytes.", oldsize, newsize );
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// Checks that the deltas give back the states they were made from, that the dirty page
+// tracking didn't miss any write to main memory since the previous snapshot, and that a
+// restored snapshot saves back to the very same state (anything that doesn't would drift a
+// little more with every rewind).  Restores the VM to the state it is in, when it works.
+bool VmStateSnapshots::Verify()
+{
+	if (!VerifyDeltas()) return false;
+
+	Take();
+
+	if (memcmp( m_ram.GetPtr(), eeMem->Main, Ps2MemSize::MainRam ) != 0)
+	{
+		Console.Error( L"(Snapshots) Dirty page check failed: main memory was written to without being tracked." );
+		return false;
+	}
+
+	const uint size = m_size;
+	std::vector<u8> state( m_buffer[m_cur].GetPtr(), m_buffer[m_cur].GetPtr() + size );
+	std::vector<u8> ram( m_ram.GetPtr(), m_ram.GetPtr() + Ps2MemSize::MainRam );
+
+	for (uint age=0; age<2; ++age)
+	{
+		// age 0 restores the snapshot just taken, age 1 walks back the (empty) delta
+		// left by the snapshot taken after it.
+		Restore( age );
+		Take();
+
+		if ((m_size != size) || (memcmp( m_buffer[m_cur].GetPtr(), state.data(), size ) != 0)
+			|| (memcmp( m_ram.GetPtr(), ram.data(), ram.size() ) != 0))
+		{
+			Console.Error( L"(Snapshots) Round trip check failed: the restored state differs (%u bytes, was %u).", m_size, size );
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static VmStateSnapshots Snapshots;
+
+// --------------------------------------------------------------------------------------
+//  SysExecEvent_TakeSnapshot / SysExecEvent_RestoreSnapshot
+// --------------------------------------------------------------------------------------
+class SysExecEvent_TakeSnapshot : public SysExecEvent
+{
+public:
+	wxString GetEventName() const { return L"VM_TakeSnapshot"; }
+
+	virtual ~SysExecEvent_TakeSnapshot() throw() {}
+	SysExecEvent_TakeSnapshot* Clone() const { return new SysExecEvent_TakeSnapshot( *this ); }
+
+	bool AllowCancelOnExit() const { return false; }
+
+protected:
+	void InvokeEvent()
+	{
+		ScopedCoreThreadPause paused_core;
+
+		if( SysHasValidState() )
+			Snapshots.Take();
+
+		paused_core.AllowResume();
+	}
+};
+
+class SysExecEvent_RestoreSnapshot : public SysExecEvent
+{
+protected:
+	uint	m_age;
+
+public:
+	wxString GetEventName() const { return L"VM_RestoreSnapshot"; }
+
+	virtual ~SysExecEvent_RestoreSnapshot() throw() {}
+	SysExecEvent_RestoreSnapshot* Clone() const { return new SysExecEvent_RestoreSnapshot( *this ); }
+	SysExecEvent_RestoreSnapshot( uint age=0 )
+	{
+		m_age = age;
+	}
+
+	bool IsCriticalEvent() const { return true; }
+	bool AllowCancelOnExit() const { return false; }
+
+protected:
+	void InvokeEvent()
+	{
+		ScopedCoreThreadPause paused_core;
+
+		if( m_age >= Snapshots.GetCount() )
+		{
+			Console.Warning( L"There's no snapshot to restore (requested %u, have %u).", m_age, Snapshots.GetCount() );
+		}
+		else if( SysHasValidState() )
+		{
+			Snapshots.Restore( m_age );
+		}
+
+		paused_core.AllowResume();
+	}
+};
+
+class SysExecEvent_VerifySnapshots : public SysExecEvent
+{
+public:
+	wxString GetEventName() const { return L"VM_VerifySnapshots"; }
+
+	virtual ~SysExecEvent_VerifySnapshots() throw() {}
+	SysExecEvent_VerifySnapshots* Clone() const { return new SysExecEvent_VerifySnapshots( *this ); }
+
+	bool AllowCancelOnExit() const { return false; }
+
+protected:
+	void InvokeEvent()
+	{
+		ScopedCoreThreadPause paused_core;
+
+		if( !SysHasValidState() )
+			Console.WriteLn( "(Snapshots) Nothing to check (VM is not active)." );
+		else if( Snapshots.Verify() )
+			Console.WriteLn( Color_StrongGreen, "(Snapshots) Round trip check passed." );
+
+		paused_core.AllowResume();
+	}
+};
+
+class SysExecEvent_ClearSnapshots : public SysExecEvent
+{
+public:
+	wxString GetEventName() const { return L"VM_ClearSnapshots"; }
+
+	virtual ~SysExecEvent_ClearSnapshots() throw() {}
+	SysExecEvent_ClearSnapshots* Clone() const { return new SysExecEvent_ClearSnapshots( *this ); }
+
+protected:
+	void InvokeEvent()
+	{
+		Snapshots.Clear();
 	}
 };
 
@@ -685,3 +1146,30 @@ void StateCopy_LoadFromSlot( uint slot, bool isFromBackup )
 
 	StateCopy_LoadFromFile( file );
 }
+
+// Snapshots are kept in memory only (and are lost on shutdown).  Main memory only costs the
+// pages written since the previous snapshot, but the rest of the state is saved in full each
+// time: see VmStateSnapshots.
+void StateCopy_TakeSnapshot()
+{
+	GetSysExecutorThread().PostEvent(new SysExecEvent_TakeSnapshot());
+}
+
+// age: 0 restores the newest snapshot, 1 the one before it, etc.  Snapshots newer than the
+// restored one are discarded.
+void StateCopy_RestoreSnapshot( uint age )
+{
+	GetSysExecutorThread().PostEvent(new SysExecEvent_RestoreSnapshot( age ));
+}
+
+void StateCopy_ClearSnapshots()
+{
+	GetSysExecutorThread().PostEvent(new SysExecEvent_ClearSnapshots());
+}
+
+// Takes a snapshot and restores it back (twice, once through a delta), checking that the
+// state comes back unchanged.  Meant for development: the result is logged to the console.
+void StateCopy_VerifySnapshots()
+{
+	GetSysExecutorThread().PostEvent(new SysExecEvent_VerifySnapshots());
+}
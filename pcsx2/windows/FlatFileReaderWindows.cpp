@@ -21,7 +21,15 @@ FlatFileReader::FlatFileReader(void)
 	m_blocksize = 2048;
 	hOverlappedFile = INVALID_HANDLE_VALUE;
 	hEvent = INVALID_HANDLE_VALUE;
+	hMapping = NULL;
 	asyncInProgress = false;
+
+	m_mapped = false;
+	m_filesize = 0;
+	m_view = NULL;
+	m_viewoffset = 0;
+	m_viewsize = 0;
+	m_viewresult = -2;
 }
 
 FlatFileReader::~FlatFileReader(void)
@@ -44,6 +52,14 @@ bool FlatFileReader::Open(const wxString& fileName)
 		FILE_FLAG_SEQUENTIAL_SCAN | FILE_FLAG_OVERLAPPED,
 		NULL);
 
+	LARGE_INTEGER fileSize;
+	if (EmuConfig.CdvdMapImages && (hOverlappedFile != INVALID_HANDLE_VALUE) && GetFileSizeEx(hOverlappedFile, &fileSize))
+	{
+		hMapping = CreateFileMapping(hOverlappedFile, NULL, PAGE_READONLY, 0, 0, NULL);
+		m_filesize = fileSize.QuadPart;
+		m_mapped = (hMapping != NULL);
+	}
+
 	return hOverlappedFile != INVALID_HANDLE_VALUE;
 }
 
@@ -65,6 +81,13 @@ int FlatFileReader::ReadSync(void* pBuffer, uint sector, uint count)
 
 void FlatFileReader::BeginRead(void* pBuffer, uint sector, uint count)
 {
+	if (const u8* src = MapBlocks(sector, count))
+	{
+		memcpy_fast(pBuffer, src, count * m_blocksize);
+		m_viewresult = count * m_blocksize;
+		return;
+	}
+
 	LARGE_INTEGER offset;
 	offset.QuadPart = sector * (s64)m_blocksize + m_dataoffset;
 	
@@ -81,6 +104,13 @@ void FlatFileReader::BeginRead(void* pBuffer, uint sector, uint count)
 
 int FlatFileReader::FinishRead(void)
 {
+	if (m_viewresult != -2)
+	{
+		int ret = m_viewresult;
+		m_viewresult = -2;
+		return ret;
+	}
+
 	DWORD bytes;
 	
 	if(!GetOverlappedResult(hOverlappedFile, &asyncOperationContext, &bytes, TRUE))
@@ -96,6 +126,9 @@ int FlatFileReader::FinishRead(void)
 void FlatFileReader::CancelRead(void)
 {
 	CancelIo(hOverlappedFile);
+
+	// A read served from the mapped view is done already; just forget its result.
+	m_viewresult = -2;
 }
 
 void FlatFileReader::Close(void)
@@ -103,6 +136,14 @@ void FlatFileReader::Close(void)
 	if(asyncInProgress)
 		CancelRead();
 
+	UnmapView();
+	m_mapped = false;
+	m_viewresult = -2;
+
+	if(hMapping != NULL)
+		CloseHandle(hMapping);
+	hMapping = NULL;
+
 	if(hOverlappedFile != INVALID_HANDLE_VALUE)
 		CloseHandle(hOverlappedFile);
 
@@ -120,3 +161,53 @@ uint FlatFileReader::GetBlockCount(void) const
 
 	return (int)(fileSize.QuadPart / m_blocksize);
 }
+
+// Returns a pointer to the given blocks, moving the view window if they're outside of it,
+// or NULL if the file isn't mapped.  If mapping fails the reader drops back to overlapped reads.
+const u8* FlatFileReader::MapBlocks(uint sector, uint count)
+{
+	if (!m_mapped) return NULL;
+
+	const s64 offset = sector * (s64)m_blocksize + m_dataoffset;
+	const s64 length = count * (s64)m_blocksize;
+	if ((offset < 0) || (offset + length > m_filesize)) return NULL;
+
+	if (!m_view || (offset < m_viewoffset) || (offset + length > m_viewoffset + m_viewsize))
+	{
+		const s64 start = offset & ~(s64)(MapAlign - 1);
+		s64 size = MapWindowSize;
+		if (size < offset + length - start) size = offset + length - start;
+		if (size > m_filesize - start) size = m_filesize - start;
+
+		UnmapView();
+
+		void* view = MapViewOfFile(hMapping, FILE_MAP_READ, (DWORD)(start >> 32), (DWORD)start, (SIZE_T)size);
+		if (view == NULL)
+		{
+			Console.Warning(L"isoFile: could not map '%s' (error %u), using regular reads.", WX_STR(m_filename), GetLastError());
+			m_mapped = false;
+			return NULL;
+		}
+
+		m_view = (u8*)view;
+		m_viewoffset = start;
+		m_viewsize = (uint)size;
+	}
+
+	return m_view + (offset - m_viewoffset);
+}
+
+void FlatFileReader::UnmapView()
+{
+	if (m_view) UnmapViewOfFile(m_view);
+
+	m_view = NULL;
+	m_viewoffset = 0;
+	m_viewsize = 0;
+}
+
+// FILE_FLAG_SEQUENTIAL_SCAN already has the cache manager read ahead; there is no portable
+// equivalent of madvise on the versions of Windows supported.
+void FlatFileReader::Prefetch(uint sector, uint count)
+{
+}
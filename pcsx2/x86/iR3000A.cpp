@@ -974,6 +974,113 @@ static __fi void recClearIOP(u32 Addr, u32 Size)
 		pc += PSXREC_CLEARM(pc);
 }
 
+// --------------------------------------------------------------------------------------
+//  IOP memory access fast paths
+// --------------------------------------------------------------------------------------
+// Main memory (all 8MB of its mirrors, in any segment) is accessed inline by the recompiled
+// code.  Everything else -- hardware registers, ROM, scratchpad, and writes while the cache
+// is isolated -- is handed to the iopMem handlers.  Inline writes check the block LUT so
+// that the recompiler is only called on when code was actually compiled from that word.
+
+static void __fastcall iopRecClearWord( u32 addr )
+{
+	psxRecClearMem( addr );
+}
+
+// Loads from the IOP address in ECX into EAX, sign or zero extended as requested.
+void rpsxMemRead( int bits, bool sign )
+{
+	xTEST( ecx, IopRamAccessMask );
+	xForwardJNZ8 slowpath;
+
+	xAND( ecx, 0x1fffff );
+	switch( bits )
+	{
+		case 8:
+			if( sign )	xMOVSX( eax, ptr8[ecx + iopMem->Main] );
+			else		xMOVZX( eax, ptr8[ecx + iopMem->Main] );
+		break;
+
+		case 16:
+			if( sign )	xMOVSX( eax, ptr16[ecx + iopMem->Main] );
+			else		xMOVZX( eax, ptr16[ecx + iopMem->Main] );
+		break;
+
+		case 32:
+			xMOV( eax, ptr32[ecx + iopMem->Main] );
+		break;
+
+		jNO_DEFAULT
+	}
+	xForwardJump8 done;
+
+	slowpath.SetTarget();
+	switch( bits )
+	{
+		case 8:
+			xCALL( iopMemRead8 );
+			if( sign )	xMOVSX( eax, al );
+			else		xMOVZX( eax, al );
+		break;
+
+		case 16:
+			xCALL( iopMemRead16 );
+			if( sign )	xMOVSX( eax, ax );
+			else		xMOVZX( eax, ax );
+		break;
+
+		case 32:
+			xCALL( iopMemRead32 );
+		break;
+
+		jNO_DEFAULT
+	}
+	done.SetTarget();
+}
+
+// Stores EDX to the IOP address in ECX.
+void rpsxMemWrite( int bits )
+{
+	xTEST( ecx, IopRamAccessMask );
+	xForwardJNZ8 slowpath1;
+	xTEST( ptr32[&psxRegs.CP0.n.Status], 0x10000 );
+	xForwardJNZ8 slowpath2;
+
+	xMOV( eax, ecx );
+	xAND( eax, 0x1fffff );
+	switch( bits )
+	{
+		case 8:		xMOV( ptr8[eax + iopMem->Main], dl );	break;
+		case 16:	xMOV( ptr16[eax + iopMem->Main], dx );	break;
+		case 32:	xMOV( ptr32[eax + iopMem->Main], edx );	break;
+
+		jNO_DEFAULT
+	}
+
+	// BASEBLOCKs are 4 bytes, one per instruction word, so the word's RAM offset doubles as
+	// the byte offset of its recRAM entry.
+	xAND( eax, 0x1ffffc );
+	xCMP( ptr32[eax + recRAM], (uptr)iopJITCompile );
+	xForwardJE8 done1;
+	xMOV( ecx, eax );
+	xCALL( iopRecClearWord );
+	xForwardJump8 done2;
+
+	slowpath1.SetTarget();
+	slowpath2.SetTarget();
+	switch( bits )
+	{
+		case 8:		xCALL( iopMemWrite8 );	break;
+		case 16:	xCALL( iopMemWrite16 );	break;
+		case 32:	xCALL( iopMemWrite32 );	break;
+
+		jNO_DEFAULT
+	}
+
+	done1.SetTarget();
+	done2.SetTarget();
+}
+
 void psxSetBranchReg(u32 reg)
 {
 	psxbranch = 1;
@@ -59,6 +59,12 @@ extern u32 g_iopCyclePenalty;
 void psxSaveBranchState();
 void psxLoadBranchState();
 
+// Address bits which must be clear for an access to hit IOP main memory (or its mirrors).
+static const u32 IopRamAccessMask = 0x1f800000;
+
+extern void rpsxMemRead( int bits, bool sign );
+extern void rpsxMemWrite( int bits );
+
 extern void psxSetBranchReg(u32 reg);
 extern void psxSetBranchImm( u32 imm );
 extern void psxRecompileNextInstruction(int delayslot);
@@ -602,113 +602,54 @@ REC_FUNC(SWR);
 
 using namespace x86Emitter;
 
-static void rpsxLB()
-{
-	_psxDeleteReg(_Rs_, 1);
-	_psxOnWriteReg(_Rt_);
-	_psxDeleteReg(_Rt_, 0);
-
-	MOV32MtoR(ECX, (uptr)&psxRegs.GPR.r[_Rs_]);
-	if (_Imm_) ADD32ItoR(ECX, _Imm_);
-	xCALL( iopMemRead8 );		// returns value in EAX
-	if (_Rt_) {
-		MOVSX32R8toR(EAX, EAX);
-		MOV32RtoM((uptr)&psxRegs.GPR.r[_Rt_], EAX);
-	}
-	PSX_DEL_CONST(_Rt_);
-}
+// Loads and stores go through rpsxMemRead/rpsxMemWrite, which access IOP main memory inline
+// and only call the iopMem handlers for everything else.  Loads from a constant address
+// in main memory are resolved at compile time.
 
-static void rpsxLBU()
+static void rpsxLoad( int bits, bool sign )
 {
 	_psxDeleteReg(_Rs_, 1);
 	_psxOnWriteReg(_Rt_);
 	_psxDeleteReg(_Rt_, 0);
 
-	MOV32MtoR(ECX, (uptr)&psxRegs.GPR.r[_Rs_]);
-	if (_Imm_) ADD32ItoR(ECX, _Imm_);
-	xCALL( iopMemRead8 );		// returns value in EAX
-	if (_Rt_) {
-		MOVZX32R8toR(EAX, EAX);
-		MOV32RtoM((uptr)&psxRegs.GPR.r[_Rt_], EAX);
-	}
-	PSX_DEL_CONST(_Rt_);
-}
-
-static void rpsxLH()
-{
-	_psxDeleteReg(_Rs_, 1);
-	_psxOnWriteReg(_Rt_);
-	_psxDeleteReg(_Rt_, 0);
-
-	MOV32MtoR(ECX, (uptr)&psxRegs.GPR.r[_Rs_]);
-	if (_Imm_) ADD32ItoR(ECX, _Imm_);
-	xCALL( iopMemRead16 );		// returns value in EAX
-	if (_Rt_) {
-		MOVSX32R16toR(EAX, EAX);
-		MOV32RtoM((uptr)&psxRegs.GPR.r[_Rt_], EAX);
-	}
-	PSX_DEL_CONST(_Rt_);
-}
-
-static void rpsxLHU()
-{
-	_psxDeleteReg(_Rs_, 1);
-	_psxOnWriteReg(_Rt_);
-	_psxDeleteReg(_Rt_, 0);
-
-	MOV32MtoR(ECX, (uptr)&psxRegs.GPR.r[_Rs_]);
-	if (_Imm_) ADD32ItoR(ECX, _Imm_);
-	xCALL( iopMemRead16 );		// returns value in EAX
-	if (_Rt_) {
-		MOVZX32R16toR(EAX, EAX);
-		MOV32RtoM((uptr)&psxRegs.GPR.r[_Rt_], EAX);
+	if( PSX_IS_CONST1(_Rs_) && !((g_psxConstRegs[_Rs_] + _Imm_) & IopRamAccessMask) )
+	{
+		if (_Rt_) {
+			const u8* src = &iopMem->Main[(g_psxConstRegs[_Rs_] + _Imm_) & 0x1fffff];
+			switch( bits )
+			{
+				case 8:
+					if( sign )	xMOVSX( eax, ptr8[src] );
+					else		xMOVZX( eax, ptr8[src] );
+				break;
+
+				case 16:
+					if( sign )	xMOVSX( eax, ptr16[src] );
+					else		xMOVZX( eax, ptr16[src] );
+				break;
+
+				case 32:
+					xMOV( eax, ptr32[src] );
+				break;
+
+				jNO_DEFAULT
+			}
+			MOV32RtoM((uptr)&psxRegs.GPR.r[_Rt_], EAX);
+		}
 	}
-	PSX_DEL_CONST(_Rt_);
-}
-
-static void rpsxLW()
-{
-	_psxDeleteReg(_Rs_, 1);
-	_psxOnWriteReg(_Rt_);
-	_psxDeleteReg(_Rt_, 0);
-
-	_psxFlushCall(FLUSH_EVERYTHING);
-	MOV32MtoR(ECX, (uptr)&psxRegs.GPR.r[_Rs_]);
-	if (_Imm_) ADD32ItoR(ECX, _Imm_);
-
-	TEST32ItoR(ECX, 0x10000000);
-	j8Ptr[0] = JZ8(0);
-
-	xCALL( iopMemRead32 );		// returns value in EAX
-	if (_Rt_) {
-		MOV32RtoM((uptr)&psxRegs.GPR.r[_Rt_], EAX);
+	else
+	{
+		MOV32MtoR(ECX, (uptr)&psxRegs.GPR.r[_Rs_]);
+		if (_Imm_) ADD32ItoR(ECX, _Imm_);
+		rpsxMemRead( bits, sign );		// returns value in EAX
+		if (_Rt_) {
+			MOV32RtoM((uptr)&psxRegs.GPR.r[_Rt_], EAX);
+		}
 	}
-	j8Ptr[1] = JMP8(0);
-	x86SetJ8(j8Ptr[0]);
-
-	// read from psM directly
-	AND32ItoR(ECX, 0x1fffff);
-	ADD32ItoR(ECX, (uptr)iopMem->Main);
-
-	MOV32RmtoR( ECX, ECX );
-	MOV32RtoM( (uptr)&psxRegs.GPR.r[_Rt_], ECX);
-
-	x86SetJ8(j8Ptr[1]);
 	PSX_DEL_CONST(_Rt_);
 }
 
-static void rpsxSB()
-{
-	_psxDeleteReg(_Rs_, 1);
-	_psxDeleteReg(_Rt_, 1);
-
-	MOV32MtoR(ECX, (uptr)&psxRegs.GPR.r[_Rs_]);
-	if (_Imm_) ADD32ItoR(ECX, _Imm_);
-	xMOV( edx, ptr[&psxRegs.GPR.r[_Rt_]] );
-	xCALL( iopMemWrite8 );
-}
-
-static void rpsxSH()
+static void rpsxStore( int bits )
 {
 	_psxDeleteReg(_Rs_, 1);
 	_psxDeleteReg(_Rt_, 1);
@@ -716,19 +657,18 @@ static void rpsxSH()
 	MOV32MtoR(ECX, (uptr)&psxRegs.GPR.r[_Rs_]);
 	if (_Imm_) ADD32ItoR(ECX, _Imm_);
 	xMOV( edx, ptr[&psxRegs.GPR.r[_Rt_]] );
-	xCALL( iopMemWrite16 );
+	rpsxMemWrite( bits );
 }
 
-static void rpsxSW()
-{
-	_psxDeleteReg(_Rs_, 1);
-	_psxDeleteReg(_Rt_, 1);
+static void rpsxLB()	{ rpsxLoad( 8, true ); }
+static void rpsxLBU()	{ rpsxLoad( 8, false ); }
+static void rpsxLH()	{ rpsxLoad( 16, true ); }
+static void rpsxLHU()	{ rpsxLoad( 16, false ); }
+static void rpsxLW()	{ rpsxLoad( 32, false ); }
 
-	MOV32MtoR(ECX, (uptr)&psxRegs.GPR.r[_Rs_]);
-	if (_Imm_) ADD32ItoR(ECX, _Imm_);
-	xMOV( edx, ptr[&psxRegs.GPR.r[_Rt_]] );
-	xCALL( iopMemWrite32 );
-}
+static void rpsxSB()	{ rpsxStore( 8 ); }
+static void rpsxSH()	{ rpsxStore( 16 ); }
+static void rpsxSW()	{ rpsxStore( 32 ); }
 
 //// SLL
 void rpsxSLL_const()
@@ -33,6 +33,7 @@
 #include "Elfheader.h"
 
 #include "../DebugTools/Breakpoints.h"
+#include "../DebugTools/MIPSAnalyst.h"
 
 #if !PCSX2_SEH
 #	include <csetjmp>
@@ -878,6 +879,11 @@ void recClear(u32 addr, u32 size)
 
 	if ((addr) >= maxrecmem || !(recLUT[(addr) >> 16] + (addr & ~0xFFFFUL)))
 		return;
+
+	// Let the debugger's function analysis know the code changed.
+	if (MIPSAnalyst::AnalysisTracking)
+		MIPSAnalyst::QueueAnalysis(addr, size * 4);
+
 	addr = HWADDR(addr);
 
 	int blockidx = recBlocks.LastIndex(addr + size * 4 - 4);
@@ -1309,8 +1315,32 @@ void __fastcall dynarecMemLogcheck(u32 start, bool store)
 		DevCon.WriteLn("Hit load breakpoint @0x%x", start);
 }
 
+// Looks the access up in the memcheck tables.  Returns nonzero if execution should break.
+static u32 __fastcall dynarecMemcheckAccess(u32 start, u32 end, bool store)
+{
+	u32 result = CBreakPoints::GetMemCheckResult(start, end, store);
+
+	if (result & MEMCHECK_LOG)
+		dynarecMemLogcheck(start, store);
+
+	return result & MEMCHECK_BREAK;
+}
+
+static u32 __fastcall dynarecMemcheckRead(u32 start, u32 end)
+{
+	return dynarecMemcheckAccess(start, end, false);
+}
+
+static u32 __fastcall dynarecMemcheckWrite(u32 start, u32 end)
+{
+	return dynarecMemcheckAccess(start, end, true);
+}
+
 void recMemcheck(u32 op, u32 bits, bool store)
 {
+	if (!CBreakPoints::HasMemChecks(store))
+		return;
+
 	iFlushCall(FLUSH_INTERPRETER);
 
 	// compute accessed address
@@ -1328,38 +1358,15 @@ void recMemcheck(u32 op, u32 bits, bool store)
 	// ecx = access address
 	// edx = access address+size
 
-	auto checks = CBreakPoints::GetMemChecks();
-	for (size_t i = 0; i < checks.size(); i++)
-	{
-		if (checks[i].result == 0)
-			continue;
-		if ((checks[i].cond & MEMCHECK_WRITE) == 0 && store == true)
-			continue;
-		if ((checks[i].cond & MEMCHECK_READ) == 0 && store == false)
-			continue;
-
-		// logic: memAddress < bpEnd && bpStart < memAddress+memSize
-		
-		xMOV(eax,standardizeBreakpointAddress(checks[i].end));
-		xCMP(ecx,eax);				// address < end
-		xForwardJGE8 next1;			// if address >= end then goto next1
-		
-		xMOV(eax,standardizeBreakpointAddress(checks[i].start));
-		xCMP(eax,edx);				// start < address+size
-		xForwardJGE8 next2;			// if start >= address+size then goto next2
-
-		// hit the breakpoint
-		if (checks[i].result & MEMCHECK_LOG) {
-			xMOV(edx, store);
-			xCALL(&dynarecMemLogcheck);
-		}
-		if (checks[i].result & MEMCHECK_BREAK) {
-			xCALL(&dynarecMemcheck);
-		}
+	if (store)
+		xCALL(&dynarecMemcheckWrite);
+	else
+		xCALL(&dynarecMemcheckRead);
 
-		next1.SetTarget();
-		next2.SetTarget();
-	}
+	xTEST(eax,eax);
+	xForwardJZ8 next;
+	xCALL(&dynarecMemcheck);
+	next.SetTarget();
 }
 
 inline bool isBranchOrJump(u32 addr)
@@ -1423,7 +1430,7 @@ int isBreakpointNeeded(u32 addr)
 
 int isMemcheckNeeded(u32 pc)
 {
-	if (CBreakPoints::GetMemChecks().size() == 0)
+	if (!CBreakPoints::HasMemChecks(false) && !CBreakPoints::HasMemChecks(true))
 		return 0;
 
 	u32 addr = pc;
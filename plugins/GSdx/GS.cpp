@@ -897,6 +897,182 @@ EXPORT_C GSsetFrameLimit(int limit)
 	}
 }
 
+// Verifies the block (un)swizzling of the current build (SSE2/SSE4/AVX2, whatever _M_SSE says)
+// against the per-pixel table lookups. Returns the number of PSMs that failed.
+static int GSVerifyBlocks(FILE* file)
+{
+	GSLocalMemory * pMem = new GSLocalMemory();
+	GSLocalMemory& mem(*pMem);
+
+	static int s_psm[] = {PSM_PSMCT32, PSM_PSMCT24, PSM_PSMCT16, PSM_PSMCT16S, PSM_PSMT8, PSM_PSMT4, PSM_PSMT8H, PSM_PSMT4HL, PSM_PSMT4HH, PSM_PSMZ32, PSM_PSMZ24, PSM_PSMZ16, PSM_PSMZ16S};
+
+	int failed = 0;
+
+	int w = 256;
+	int h = 256;
+
+	uint8* src = (uint8*)_aligned_malloc(w * h * 4, 32);
+	uint8* dst = (uint8*)_aligned_malloc(w * h * 4, 32);
+
+	srand(0);
+
+	for(int i = 0; i < w * h * 4; i++) src[i] = (uint8)rand();
+
+	for(size_t i = 0; i < countof(s_psm); i++)
+	{
+		const GSLocalMemory::psm_t& psm = GSLocalMemory::m_psm[s_psm[i]];
+
+		GIFRegBITBLTBUF BITBLTBUF;
+
+		BITBLTBUF.SBP = 0;
+		BITBLTBUF.SBW = w / 64;
+		BITBLTBUF.SPSM = s_psm[i];
+		BITBLTBUF.DBP = 0;
+		BITBLTBUF.DBW = w / 64;
+		BITBLTBUF.DPSM = s_psm[i];
+
+		GIFRegTRXPOS TRXPOS;
+
+		TRXPOS.SSAX = 0;
+		TRXPOS.SSAY = 0;
+		TRXPOS.DSAX = 0;
+		TRXPOS.DSAY = 0;
+
+		GIFRegTRXREG TRXREG;
+
+		TRXREG.RRW = w;
+		TRXREG.RRH = h;
+
+		GIFRegTEX0 TEX0;
+
+		TEX0.TBP0 = 0;
+		TEX0.TBW = w / 64;
+		TEX0.PSM = s_psm[i];
+
+		GIFRegTEXA TEXA;
+
+		TEXA.TA0 = 0x40;
+		TEXA.TA1 = 0x80;
+		TEXA.AEM = 1;
+
+		int trlen = w * h * psm.trbpp / 8;
+		int errors = 0;
+		int x, y;
+
+		x = y = 0;
+		(mem.*psm.wi)(x, y, src, trlen, BITBLTBUF, TRXPOS, TRXREG);
+
+		x = y = 0;
+		(mem.*psm.ri)(x, y, dst, trlen, BITBLTBUF, TRXPOS, TRXREG);
+
+		if(memcmp(src, dst, trlen) != 0) errors++;
+
+		if(psm.pal > 0)
+		{
+			TEX0.CBP = 0x3000;
+			TEX0.CPSM = PSM_PSMCT32;
+			TEX0.CSM = 0;
+			TEX0.CSA = 0;
+			TEX0.CLD = 1;
+
+			for(int j = 0; j < 256; j++)
+			{
+				mem.WritePixel32(j & 15, j >> 4, (uint32)rand() | ((uint32)rand() << 16), TEX0.CBP, 1);
+			}
+
+			GIFRegTEXCLUT TEXCLUT;
+
+			TEXCLUT.u64 = 0;
+
+			mem.m_clut.Write(TEX0, TEXCLUT);
+			mem.m_clut.Read32(TEX0, TEXA);
+		}
+
+		(mem.*psm.rtx)(mem.GetOffset(TEX0.TBP0, TEX0.TBW, TEX0.PSM), GSVector4i(0, 0, w, h), dst, w * 4, TEXA);
+
+		for(y = 0; y < h; y++)
+		{
+			for(x = 0; x < w; x++)
+			{
+				if(((uint32*)dst)[y * w + x] != (mem.*psm.rt)(x, y, TEX0, TEXA)) errors++;
+			}
+		}
+
+		fprintf(file, "[%02x] %s (%d)\n", s_psm[i], errors == 0 ? "ok" : "failed", errors);
+
+		if(errors) failed++;
+	}
+
+	fprintf(file, "\n");
+
+	_aligned_free(dst);
+	_aligned_free(src);
+
+	delete pMem;
+
+	return failed;
+}
+
+// Checks that GSTextureCacheSW::HashPage tells apart single and double bit flips of a random page.
+// Flipping bit 31 of dword 0 or of dword 16 used to give the same hash, revalidating stale textures.
+static int GSVerifyPageHash(FILE* file)
+{
+	uint32* page = (uint32*)_aligned_malloc(PAGE_SIZE, 32);
+
+	const int n = PAGE_SIZE / sizeof(uint32);
+
+	srand(1);
+
+	for(int i = 0; i < n; i++) page[i] = (uint32)rand() | ((uint32)rand() << 16);
+
+	vector<uint64> hashes;
+
+	hashes.push_back(GSTextureCacheSW::HashPage((const uint8*)page));
+
+	for(int i = 0; i < n; i++)
+	{
+		for(int j = 0; j < 32; j++)
+		{
+			if(i >= 32 && j != 0 && j != 31) continue;
+
+			page[i] ^= 1u << j;
+			hashes.push_back(GSTextureCacheSW::HashPage((const uint8*)page));
+			page[i] ^= 1u << j;
+		}
+	}
+
+	for(int i = 0; i + 16 < n; i++)
+	{
+		page[i] ^= 0x80000000;
+		page[i + 16] ^= 0x80000000;
+		hashes.push_back(GSTextureCacheSW::HashPage((const uint8*)page));
+		page[i] ^= 0x80000000;
+		page[i + 16] ^= 0x80000000;
+	}
+
+	size_t count = hashes.size();
+
+	std::sort(hashes.begin(), hashes.end());
+
+	int collisions = (int)(count - (std::unique(hashes.begin(), hashes.end()) - hashes.begin()));
+
+	fprintf(file, "[page hash] %s (%d collisions in %d pages)\n\n", collisions == 0 ? "ok" : "failed", collisions, (int)count);
+
+	_aligned_free(page);
+
+	return collisions != 0 ? 1 : 0;
+}
+
+// Standalone entry point of the checks above, for the replay loader on linux and for scripts on windows
+EXPORT_C_(int) GSVerify()
+{
+	int failed = GSVerifyBlocks(stderr) + GSVerifyPageHash(stderr);
+
+	fprintf(stderr, "%s\n", failed == 0 ? "verification passed" : "verification FAILED");
+
+	return failed;
+}
+
 #ifdef _WINDOWS
 
 #include <io.h>
@@ -1222,6 +1398,8 @@ EXPORT_C GSBenchmark(HWND hwnd, HINSTANCE hinst, LPSTR lpszCmdLine, int nCmdShow
 
 	fprintf(file, "-------------------------\n\n");
 
+	GSVerifyBlocks(file);
+
 	if(1)
 	{
 		GSLocalMemory * pMem = new GSLocalMemory();
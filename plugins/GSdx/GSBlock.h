@@ -326,6 +326,43 @@ public:
 	{
 		//printf("WriteColumn4\n");
 
+		#if _M_SSE >= 0x501
+
+		// rows 0/1 and 2/3 share a register, the pairing of sw4/sw8 keeps them in separate lanes until the final acbd
+
+		GSVector4i v4 = GSVector4i::load<alignment != 0>(&src[srcpitch * 0]);
+		GSVector4i v5 = GSVector4i::load<alignment != 0>(&src[srcpitch * 1]);
+		GSVector4i v6 = GSVector4i::load<alignment != 0>(&src[srcpitch * 2]);
+		GSVector4i v7 = GSVector4i::load<alignment != 0>(&src[srcpitch * 3]);
+
+		GSVector8i v0 = GSVector8i::cast(v4).insert<1>(v5);
+		GSVector8i v1 = GSVector8i::cast(v6).insert<1>(v7);
+
+		if((i & 1) == 0)
+		{
+			v1 = v1.yxwzlh();
+		}
+		else
+		{
+			v0 = v0.yxwzlh();
+		}
+
+		GSVector8i mask(0x0f0f0f0f);
+
+		GSVector8i v2 = (v1 << 4).blend(v0, mask);
+		GSVector8i v3 = v1.blend(v0 >> 4, mask);
+
+		v0 = v2.upl8(v3);
+		v1 = v2.uph8(v3);
+
+		GSVector8i::sw8(v0, v1);
+		GSVector8i::sw8(v0, v1);
+
+		((GSVector8i*)dst)[i * 2 + 0] = v0.acbd();
+		((GSVector8i*)dst)[i * 2 + 1] = v1.acbd();
+
+		#else
+
 		// TODO: read unaligned as WriteColumn32 does and try saving a few shuffles
 
 		// TODO: pshufb
@@ -355,6 +392,8 @@ public:
 		((GSVector4i*)dst)[i * 4 + 1] = v1;
 		((GSVector4i*)dst)[i * 4 + 2] = v2;
 		((GSVector4i*)dst)[i * 4 + 3] = v3;
+
+		#endif
 	}
 
 	template<int alignment, uint32 mask> static void WriteColumn32(int y, uint8* RESTRICT dst, const uint8* RESTRICT src, int srcpitch)
@@ -550,33 +589,96 @@ public:
 		#endif
 	}
 
-	template<int i> __forceinline static void ReadColumn8(const uint8* RESTRICT src, uint8* RESTRICT dst, int dstpitch)
+	#if _M_SSE >= 0x501
+
+	// unswizzles one column into two registers, v0 = rows 0 and 2, v1 = rows 1 and 3
+
+	__forceinline static void ReadColumn8(int i, const uint8* RESTRICT src, GSVector8i& v0, GSVector8i& v1)
 	{
-		//for(int j = 0; j < 64; j++) ((uint8*)src)[j] = (uint8)j;
+		const GSVector4i* s = (const GSVector4i*)src;
 
-		#if 0//_M_SSE >= 0x501
+		GSVector8i mask = GSVector8i::broadcast128(m_r8mask);
 
-		const GSVector8i* s = (const GSVector8i*)src;
-		
-		GSVector8i v0 = s[i * 2 + 0];
-		GSVector8i v1 = s[i * 2 + 1];
+		if((i & 1) == 0)
+		{
+			v0 = GSVector8i::load(&s[i * 4 + 0], &s[i * 4 + 2]);
+			v1 = GSVector8i::load(&s[i * 4 + 1], &s[i * 4 + 3]);
+		}
+		else
+		{
+			v0 = GSVector8i::load(&s[i * 4 + 2], &s[i * 4 + 0]);
+			v1 = GSVector8i::load(&s[i * 4 + 3], &s[i * 4 + 1]);
+		}
+
+		v0 = v0.shuffle8(mask);
+		v1 = v1.shuffle8(mask);
 
-		GSVector8i::sw8(v0, v1);
 		GSVector8i::sw16(v0, v1);
+
+		GSVector8i v2 = v0.ad(v1);
+		GSVector8i v3 = v0.bc(v1);
+
+		v0 = v2.upl32(v3);
+		v1 = v2.uph32(v3);
+	}
+
+	// unswizzles one column into two registers, v0 = rows 0 and 1, v1 = rows 2 and 3
+
+	__forceinline static void ReadColumn4(int i, const uint8* RESTRICT src, GSVector8i& v0, GSVector8i& v1)
+	{
+		const GSVector4i* s = (const GSVector4i*)src;
+
+		v0 = GSVector8i::load(&s[i * 4 + 0], &s[i * 4 + 2]).xzyw();
+		v1 = GSVector8i::load(&s[i * 4 + 1], &s[i * 4 + 3]).xzyw();
+
+		GSVector8i::sw64(v0, v1);
+
+		GSVector8i mask(0x0f0f0f0f);
+
+		GSVector8i v2 = (v1 << 4).blend(v0, mask);
+		GSVector8i v3 = v1.blend(v0 >> 4, mask);
+
+		v0 = v2.upl8(v3);
+		v1 = v2.uph8(v3);
+
 		GSVector8i::sw8(v0, v1);
+
+		mask = GSVector8i::broadcast128(m_r4mask);
+
+		v0 = v0.shuffle8(mask);
+		v1 = v1.shuffle8(mask);
+
 		GSVector8i::sw128(v0, v1);
-		GSVector8i::sw16(v0, v1);
 
-		v0 = v0.acbd();
-		v1 = v1.acbd();
-		v1 = v1.yxwz();
+		v2 = v0;
+		v3 = v1;
 
-		GSVector8i::storel(&dst[dstpitch * 0], v0);
-		GSVector8i::storeh(&dst[dstpitch * 1], v0);
-		GSVector8i::storel(&dst[dstpitch * 2], v1);
-		GSVector8i::storeh(&dst[dstpitch * 3], v1);
+		if((i & 1) == 0)
+		{
+			v0 = v2.upl16(v3);
+			v1 = v3.uph16(v2);
+		}
+		else
+		{
+			v0 = v3.upl16(v2);
+			v1 = v2.uph16(v3);
+		}
+	}
+
+	#endif
+
+	template<int i> __forceinline static void ReadColumn8(const uint8* RESTRICT src, uint8* RESTRICT dst, int dstpitch)
+	{
+		//for(int j = 0; j < 64; j++) ((uint8*)src)[j] = (uint8)j;
 
-		// TODO: not sure if this is worth it, not in this form, there should be a shorter path
+		#if _M_SSE >= 0x501
+
+		GSVector8i v0, v1;
+
+		ReadColumn8(i, src, v0, v1);
+
+		GSVector8i::store(&dst[dstpitch * 0], &dst[dstpitch * 2], v0);
+		GSVector8i::store(&dst[dstpitch * 1], &dst[dstpitch * 3], v1);
 
 		#elif _M_SSE >= 0x301
 
@@ -649,7 +751,16 @@ public:
 	{
 		//printf("ReadColumn4\n");
 
-		#if _M_SSE >= 0x301
+		#if _M_SSE >= 0x501
+
+		GSVector8i v0, v1;
+
+		ReadColumn4(i, src, v0, v1);
+
+		GSVector8i::store(&dst[dstpitch * 0], &dst[dstpitch * 1], v0);
+		GSVector8i::store(&dst[dstpitch * 2], &dst[dstpitch * 3], v1);
+
+		#elif _M_SSE >= 0x301
 
 		const GSVector4i* s = (const GSVector4i*)src;
 
@@ -1930,7 +2041,36 @@ public:
 	{
 		//printf("ReadAndExpandBlock8_32\n");
 
-		#if _M_SSE >= 0x401
+		#if _M_SSE >= 0x501
+
+		GSVector8i v0, v1;
+
+		for(int i = 0; i < 4; i++)
+		{
+			ReadColumn8(i, src, v0, v1);
+
+			GSVector8i* d0 = (GSVector8i*)&dst[dstpitch * 0];
+			GSVector8i* d1 = (GSVector8i*)&dst[dstpitch * 1];
+			GSVector8i* d2 = (GSVector8i*)&dst[dstpitch * 2];
+			GSVector8i* d3 = (GSVector8i*)&dst[dstpitch * 3];
+
+			d0[0] = v0.u8to32c().gather32_32<>(pal);
+			d0[1] = v0.srl<8>().u8to32c().gather32_32<>(pal);
+			d1[0] = v1.u8to32c().gather32_32<>(pal);
+			d1[1] = v1.srl<8>().u8to32c().gather32_32<>(pal);
+
+			v0 = v0.bb();
+			v1 = v1.bb();
+
+			d2[0] = v0.u8to32c().gather32_32<>(pal);
+			d2[1] = v0.srl<8>().u8to32c().gather32_32<>(pal);
+			d3[0] = v1.u8to32c().gather32_32<>(pal);
+			d3[1] = v1.srl<8>().u8to32c().gather32_32<>(pal);
+
+			dst += dstpitch * 4;
+		}
+
+		#elif _M_SSE >= 0x401
 
 		const GSVector4i* s = (const GSVector4i*)src;
 
@@ -1991,7 +2131,28 @@ public:
 	{
 		//printf("ReadAndExpandBlock4_32\n");
 
-		#if _M_SSE >= 0x401
+		#if _M_SSE >= 0x501
+
+		GSVector8i v[2];
+
+		for(int i = 0; i < 4; i++)
+		{
+			ReadColumn4(i, src, v[0], v[1]);
+
+			for(int j = 0; j < 4; j++, dst += dstpitch)
+			{
+				GSVector4i r = j & 1 ? v[j >> 1].extract<1>() : v[j >> 1].extract<0>();
+
+				GSVector8i* d = (GSVector8i*)dst;
+
+				d[0] = GSVector8i::gather64_32(pal, r.u8to32());
+				d[1] = GSVector8i::gather64_32(pal, r.srl<4>().u8to32());
+				d[2] = GSVector8i::gather64_32(pal, r.srl<8>().u8to32());
+				d[3] = GSVector8i::gather64_32(pal, r.srl<12>().u8to32());
+			}
+		}
+
+		#elif _M_SSE >= 0x401
 
 		const GSVector4i* s = (const GSVector4i*)src;
 
@@ -2068,7 +2229,27 @@ public:
 	{
 		//printf("ReadAndExpandBlock8H_32\n");
 
-		#if _M_SSE >= 0x401
+		#if _M_SSE >= 0x501
+
+		const GSVector8i* s = (const GSVector8i*)src;
+
+		GSVector8i v0, v1;
+
+		for(int i = 0; i < 4; i++)
+		{
+			v0 = s[i * 2 + 0];
+			v1 = s[i * 2 + 1];
+
+			GSVector8i::sw128(v0, v1);
+			GSVector8i::sw64(v0, v1);
+
+			*(GSVector8i*)&dst[dstpitch * 0] = (v0 >> 24).gather32_32<>(pal);
+			*(GSVector8i*)&dst[dstpitch * 1] = (v1 >> 24).gather32_32<>(pal);
+
+			dst += dstpitch * 2;
+		}
+
+		#elif _M_SSE >= 0x401
 
 		const GSVector4i* s = (const GSVector4i*)src;
 
@@ -2111,7 +2292,27 @@ public:
 	{
 		//printf("ReadAndExpandBlock4HL_32\n");
 
-		#if _M_SSE >= 0x401
+		#if _M_SSE >= 0x501
+
+		const GSVector8i* s = (const GSVector8i*)src;
+
+		GSVector8i v0, v1;
+
+		for(int i = 0; i < 4; i++)
+		{
+			v0 = s[i * 2 + 0];
+			v1 = s[i * 2 + 1];
+
+			GSVector8i::sw128(v0, v1);
+			GSVector8i::sw64(v0, v1);
+
+			*(GSVector8i*)&dst[dstpitch * 0] = ((v0 >> 24) & 0xf).gather32_32<>(pal);
+			*(GSVector8i*)&dst[dstpitch * 1] = ((v1 >> 24) & 0xf).gather32_32<>(pal);
+
+			dst += dstpitch * 2;
+		}
+
+		#elif _M_SSE >= 0x401
 
 		const GSVector4i* s = (const GSVector4i*)src;
 
@@ -2154,7 +2355,27 @@ public:
 	{
 		//printf("ReadAndExpandBlock4HH_32\n");
 
-		#if _M_SSE >= 0x401
+		#if _M_SSE >= 0x501
+
+		const GSVector8i* s = (const GSVector8i*)src;
+
+		GSVector8i v0, v1;
+
+		for(int i = 0; i < 4; i++)
+		{
+			v0 = s[i * 2 + 0];
+			v1 = s[i * 2 + 1];
+
+			GSVector8i::sw128(v0, v1);
+			GSVector8i::sw64(v0, v1);
+
+			*(GSVector8i*)&dst[dstpitch * 0] = (v0 >> 28).gather32_32<>(pal);
+			*(GSVector8i*)&dst[dstpitch * 1] = (v1 >> 28).gather32_32<>(pal);
+
+			dst += dstpitch * 2;
+		}
+
+		#elif _M_SSE >= 0x401
 
 		const GSVector4i* s = (const GSVector4i*)src;
 
@@ -33,7 +33,8 @@ const GSVector8 g_pos_scale2(1.0f / 16, 1.0f / 16, 1.0f, 128.0f, 1.0f / 16, 1.0f
 #endif
 
 GSRendererSW::GSRendererSW(int threads)
-	: m_fzb(NULL)
+	: m_pool(NULL)
+	, m_fzb(NULL)
 {
 	m_nativeres = true; // ignore ini, sw is always native
 
@@ -43,6 +44,15 @@ GSRendererSW::GSRendererSW(int threads)
 
 	m_rl = GSRasterizerList::Create<GSDrawScanline>(threads, &m_perfmon);
 
+	if(threads > 0)
+	{
+		// vertex trace and conversion of large draws, the rasterizer threads are busy with the previous ones
+
+		m_pool = new GSWorkerPool(std::min<int>(threads, 7));
+
+		m_vt.SetWorkerPool(m_pool);
+	}
+
 	m_output = (uint8*)_aligned_malloc(1024 * 1024 * sizeof(uint32), 32);
 
 	memset(m_fzb_pages, 0, sizeof(m_fzb_pages));
@@ -71,6 +81,10 @@ GSRendererSW::~GSRendererSW()
 
 	delete m_rl;
 
+	m_vt.SetWorkerPool(NULL);
+
+	delete m_pool;
+
 	_aligned_free(m_output);
 }
 
@@ -274,7 +288,7 @@ void GSRendererSW::ConvertVertexBuffer(GSVertexSW* RESTRICT dst, const GSVertex*
 	GSVector8i o2((GSVector4i)m_context->XYOFFSET);
 	GSVector8 tsize2(GSVector4(0x10000 << m_context->TEX0.TW, 0x10000 << m_context->TEX0.TH, 1, 0));
 
-	for(int i = (int)m_vertex.next; i > 0; i -= 2, src += 2, dst += 2) // ok to overflow, allocator makes sure there is one more dummy vertex
+	for(int i = (int)count; i > 0; i -= 2, src += 2, dst += 2) // ok to overflow, allocator makes sure there is one more dummy vertex
 	{
 		GSVector8i v0 = GSVector8i::load<true>(src[0].m);
 		GSVector8i v1 = GSVector8i::load<true>(src[1].m);
@@ -338,7 +352,7 @@ void GSRendererSW::ConvertVertexBuffer(GSVertexSW* RESTRICT dst, const GSVertex*
 	GSVector4i o = (GSVector4i)m_context->XYOFFSET;
 	GSVector4 tsize = GSVector4(0x10000 << m_context->TEX0.TW, 0x10000 << m_context->TEX0.TH, 1, 0);
 
-	for(int i = (int)m_vertex.next; i > 0; i--, src++, dst++)
+	for(int i = (int)count; i > 0; i--, src++, dst++)
 	{
 		GSVector4 stcq = GSVector4::load<true>(&src->m[0]); // s t rgba q
 
@@ -408,6 +422,13 @@ void GSRendererSW::ConvertVertexBuffer(GSVertexSW* RESTRICT dst, const GSVertex*
 	#endif
 }
 
+void GSRendererSW::ConvertVertexBufferPart(void* param, int part, int begin, int end)
+{
+	ConvertVertexBufferJob* job = (ConvertVertexBufferJob*)param;
+
+	(job->r->*job->cvb)(job->dst + begin, job->src + begin, end - begin);
+}
+
 void GSRendererSW::Draw()
 {
 	const GSDrawingContext* context = m_context;
@@ -423,7 +444,18 @@ void GSRendererSW::Draw()
 	sd->index = (uint32*)(sd->buff + sizeof(GSVertexSW) * ((m_vertex.next + 1) & ~1));
 	sd->index_count = m_index.tail;
 
-	(this->*m_cvb[m_vt.m_primclass][PRIM->TME][PRIM->FST])(sd->vertex, m_vertex.buff, m_vertex.next);
+	ConvertVertexBufferPtr cvb = m_cvb[m_vt.m_primclass][PRIM->TME][PRIM->FST];
+
+	if(m_pool != NULL && m_vertex.next >= GSWorkerPool::MinItems)
+	{
+		ConvertVertexBufferJob job = {this, cvb, sd->vertex, m_vertex.buff};
+
+		m_pool->Run(ConvertVertexBufferPart, &job, m_vertex.next, 2); // even parts, the avx path converts pairs
+	}
+	else
+	{
+		(this->*cvb)(sd->vertex, m_vertex.buff, m_vertex.next);
+	}
 
 	memcpy(sd->index, m_index.buff, sizeof(uint32) * m_index.tail);
 
@@ -678,7 +710,7 @@ void GSRendererSW::InvalidateVideoMem(const GIFRegBITBLTBUF& BITBLTBUF, const GS
 		}
 	}
 
-	m_tc->InvalidatePages(m_tmp_pages, o->psm); // if texture update runs on a thread and Sync(5) happens then this must come later
+	m_tc->InvalidateVideoMem(m_tmp_pages, o->psm); // if texture update runs on a thread and Sync(5) happens then this must come later
 }
 
 void GSRendererSW::InvalidateLocalMem(const GIFRegBITBLTBUF& BITBLTBUF, const GSVector4i& r, bool clut)
@@ -63,8 +63,19 @@ class GSRendererSW : public GSRenderer
 	template<uint32 primclass, uint32 tme, uint32 fst>
 	void ConvertVertexBuffer(GSVertexSW* RESTRICT dst, const GSVertex* RESTRICT src, size_t count);
 
+	struct ConvertVertexBufferJob
+	{
+		GSRendererSW* r;
+		ConvertVertexBufferPtr cvb;
+		GSVertexSW* dst;
+		const GSVertex* src;
+	};
+
+	static void ConvertVertexBufferPart(void* param, int part, int begin, int end);
+
 protected:
 	IRasterizer* m_rl;
+	GSWorkerPool* m_pool;
 	GSTextureCacheSW* m_tc;
 	GSTexture* m_texture[2];
 	uint8* m_output;
@@ -177,8 +177,10 @@ void GSState::SetFrameSkip(int skip)
 		m_fpGIFRegHandlers[GIF_A_D_REG_XYZF3] = &GSState::GIFRegHandlerNOP;
 		m_fpGIFRegHandlers[GIF_A_D_REG_XYZ3] = &GSState::GIFRegHandlerNOP;
 
-		m_fpGIFPackedRegHandlersC[GIF_REG_STQRGBAXYZF2] = &GSState::GIFPackedRegHandlerNOP;
-		m_fpGIFPackedRegHandlersC[GIF_REG_STQRGBAXYZ2] = &GSState::GIFPackedRegHandlerNOP;
+		for(size_t i = 0; i < countof(m_fpGIFPackedRegHandlersC); i++)
+		{
+			m_fpGIFPackedRegHandlersC[i] = &GSState::GIFPackedRegHandlerNOP;
+		}
 	}
 	else
 	{
@@ -258,6 +260,11 @@ void GSState::ResetHandlers()
 		m_fpGIFRegHandlerXYZ[P][3] = &GSState::GIFRegHandlerXYZ2<P, 1>; \
 		m_fpGIFPackedRegHandlerSTQRGBAXYZF2[P] = &GSState::GIFPackedRegHandlerSTQRGBAXYZF2<P>; \
 		m_fpGIFPackedRegHandlerSTQRGBAXYZ2[P] = &GSState::GIFPackedRegHandlerSTQRGBAXYZ2<P>; \
+		m_fpGIFPackedRegHandlerUVRGBAXYZF2[P] = &GSState::GIFPackedRegHandlerLoop<P, 0x040103>; \
+		m_fpGIFPackedRegHandlerUVRGBAXYZ2[P] = &GSState::GIFPackedRegHandlerLoop<P, 0x050103>; \
+		m_fpGIFPackedRegHandlerRGBAXYZF2[P] = &GSState::GIFPackedRegHandlerLoop<P, 0x0401>; \
+		m_fpGIFPackedRegHandlerRGBAXYZ2[P] = &GSState::GIFPackedRegHandlerLoop<P, 0x0501>; \
+		m_fpGIFPackedRegHandlerSTQRGBAXYZF2FOG[P] = &GSState::GIFPackedRegHandlerLoop<P, 0x0a040102>; \
 
 	SetHandlerXYZ(GS_POINTLIST);
 	SetHandlerXYZ(GS_LINELIST);
@@ -622,6 +629,36 @@ void GSState::GIFPackedRegHandlerSTQRGBAXYZ2(const GIFPackedReg* RESTRICT r, uin
 	m_q = r[-3].STQ.Q; // remember the last one, STQ outputs this to the temp Q each time
 }
 
+template<uint32 prim, uint32 regs>
+void GSState::GIFPackedRegHandlerLoop(const GIFPackedReg* RESTRICT r, uint32 size)
+{
+	// regs: the register list of the tag, one per byte, the loop body is resolved at compile time and calls the handlers directly
+
+	const GIFPackedReg* RESTRICT r_end = r + size;
+
+	while(r < r_end)
+	{
+		r = GIFPackedRegHandlerStep<prim, regs>(r);
+	}
+}
+
+template<uint32 prim, uint32 regs>
+__forceinline const GIFPackedReg* GSState::GIFPackedRegHandlerStep(const GIFPackedReg* RESTRICT r)
+{
+	switch(regs & 0xff)
+	{
+	case GIF_REG_RGBA: GIFPackedRegHandlerRGBA(r); break;
+	case GIF_REG_STQ: GIFPackedRegHandlerSTQ(r); break;
+	case GIF_REG_UV: if(!UserHacks_WildHack) GIFPackedRegHandlerUV(r); else GIFPackedRegHandlerUV_Hack(r); break;
+	case GIF_REG_XYZF2: GIFPackedRegHandlerXYZF2<prim, 0>(r); break;
+	case GIF_REG_XYZ2: GIFPackedRegHandlerXYZ2<prim, 0>(r); break;
+	case GIF_REG_FOG: GIFPackedRegHandlerFOG(r); break;
+	default: __assume(0);
+	}
+
+	return (regs >> 8) != 0 ? GIFPackedRegHandlerStep<prim, (regs >> 8)>(r + 1) : r + 1;
+}
+
 void GSState::GIFPackedRegHandlerNOP(const GIFPackedReg* RESTRICT r, uint32 size)
 {
 }
@@ -1925,6 +1962,46 @@ template<int index> void GSState::Transfer(const uint8* mem, uint32 size)
 
 						break;
 
+					case GIFPath::TYPE_UVRGBAXYZF2:
+
+						(this->*m_fpGIFPackedRegHandlersC[GIF_REG_UVRGBAXYZF2])((GIFPackedReg*)mem, total);
+
+						mem += total * sizeof(GIFPackedReg);
+
+						break;
+
+					case GIFPath::TYPE_UVRGBAXYZ2:
+
+						(this->*m_fpGIFPackedRegHandlersC[GIF_REG_UVRGBAXYZ2])((GIFPackedReg*)mem, total);
+
+						mem += total * sizeof(GIFPackedReg);
+
+						break;
+
+					case GIFPath::TYPE_RGBAXYZF2:
+
+						(this->*m_fpGIFPackedRegHandlersC[GIF_REG_RGBAXYZF2])((GIFPackedReg*)mem, total);
+
+						mem += total * sizeof(GIFPackedReg);
+
+						break;
+
+					case GIFPath::TYPE_RGBAXYZ2:
+
+						(this->*m_fpGIFPackedRegHandlersC[GIF_REG_RGBAXYZ2])((GIFPackedReg*)mem, total);
+
+						mem += total * sizeof(GIFPackedReg);
+
+						break;
+
+					case GIFPath::TYPE_STQRGBAXYZF2FOG:
+
+						(this->*m_fpGIFPackedRegHandlersC[GIF_REG_STQRGBAXYZF2FOG])((GIFPackedReg*)mem, total);
+
+						mem += total * sizeof(GIFPackedReg);
+
+						break;
+
 					default:
 
 						__assume(0);
@@ -2307,6 +2384,11 @@ void GSState::UpdateVertexKick()
 
 	m_fpGIFPackedRegHandlersC[GIF_REG_STQRGBAXYZF2] = m_fpGIFPackedRegHandlerSTQRGBAXYZF2[prim];
 	m_fpGIFPackedRegHandlersC[GIF_REG_STQRGBAXYZ2] = m_fpGIFPackedRegHandlerSTQRGBAXYZ2[prim];
+	m_fpGIFPackedRegHandlersC[GIF_REG_UVRGBAXYZF2] = m_fpGIFPackedRegHandlerUVRGBAXYZF2[prim];
+	m_fpGIFPackedRegHandlersC[GIF_REG_UVRGBAXYZ2] = m_fpGIFPackedRegHandlerUVRGBAXYZ2[prim];
+	m_fpGIFPackedRegHandlersC[GIF_REG_RGBAXYZF2] = m_fpGIFPackedRegHandlerRGBAXYZF2[prim];
+	m_fpGIFPackedRegHandlersC[GIF_REG_RGBAXYZ2] = m_fpGIFPackedRegHandlerRGBAXYZ2[prim];
+	m_fpGIFPackedRegHandlersC[GIF_REG_STQRGBAXYZF2FOG] = m_fpGIFPackedRegHandlerSTQRGBAXYZF2FOG[prim];
 }
 
 void GSState::GrowVertexBuffer()
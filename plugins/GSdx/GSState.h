@@ -62,12 +62,19 @@ class GSState : public GSAlignedClass<32>
 
 	typedef void (GSState::*GIFPackedRegHandlerC)(const GIFPackedReg* RESTRICT r, uint32 size);
 
-	GIFPackedRegHandlerC m_fpGIFPackedRegHandlersC[2];
+	GIFPackedRegHandlerC m_fpGIFPackedRegHandlersC[GIF_REG_COMPLEX_COUNT];
 	GIFPackedRegHandlerC m_fpGIFPackedRegHandlerSTQRGBAXYZF2[8];
 	GIFPackedRegHandlerC m_fpGIFPackedRegHandlerSTQRGBAXYZ2[8];
+	GIFPackedRegHandlerC m_fpGIFPackedRegHandlerUVRGBAXYZF2[8];
+	GIFPackedRegHandlerC m_fpGIFPackedRegHandlerUVRGBAXYZ2[8];
+	GIFPackedRegHandlerC m_fpGIFPackedRegHandlerRGBAXYZF2[8];
+	GIFPackedRegHandlerC m_fpGIFPackedRegHandlerRGBAXYZ2[8];
+	GIFPackedRegHandlerC m_fpGIFPackedRegHandlerSTQRGBAXYZF2FOG[8];
 
 	template<uint32 prim> void GIFPackedRegHandlerSTQRGBAXYZF2(const GIFPackedReg* RESTRICT r, uint32 size);
 	template<uint32 prim> void GIFPackedRegHandlerSTQRGBAXYZ2(const GIFPackedReg* RESTRICT r, uint32 size);
+	template<uint32 prim, uint32 regs> void GIFPackedRegHandlerLoop(const GIFPackedReg* RESTRICT r, uint32 size);
+	template<uint32 prim, uint32 regs> const GIFPackedReg* GIFPackedRegHandlerStep(const GIFPackedReg* RESTRICT r);
 	void GIFPackedRegHandlerNOP(const GIFPackedReg* RESTRICT r, uint32 size);
 
 	template<int i> void ApplyTEX0(GIFRegTEX0& TEX0);
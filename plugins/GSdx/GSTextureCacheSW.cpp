@@ -25,6 +25,12 @@
 GSTextureCacheSW::GSTextureCacheSW(GSState* state)
 	: m_state(state)
 {
+	m_budget = (uint64)std::max<int>(theApp.GetConfig("swtc_budget", 256), 16) << 20;
+
+	memset(m_dirty.bm, 0, sizeof(m_dirty.bm));
+	memset(m_dirty.hashed, 0, sizeof(m_dirty.hashed));
+
+	m_dirty.pending = false;
 }
 
 GSTextureCacheSW::~GSTextureCacheSW()
@@ -34,6 +40,8 @@ GSTextureCacheSW::~GSTextureCacheSW()
 
 GSTextureCacheSW::Texture* GSTextureCacheSW::Lookup(const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA, uint32 tw0)
 {
+	FlushDirtyPages();
+
 	const GSLocalMemory::psm_t& psm = GSLocalMemory::m_psm[TEX0.PSM];
 
 	Texture* t = NULL;
@@ -85,6 +93,8 @@ GSTextureCacheSW::Texture* GSTextureCacheSW::Lookup(const GIFRegTEX0& TEX0, cons
 
 void GSTextureCacheSW::InvalidatePages(const uint32* pages, uint32 psm)
 {
+	FlushDirtyPages();
+
 	for(const uint32* p = pages; *p != GSOffset::EOP; p++)
 	{
 		uint32 page = *p;
@@ -110,6 +120,8 @@ void GSTextureCacheSW::InvalidatePages(const uint32* pages, uint32 psm)
 				}
 				else
 				{
+					t->m_revalidate.bm[page >> 5] &= ~(1 << (page & 31));
+
 					valid[page] = 0;
 				}
 
@@ -119,6 +131,114 @@ void GSTextureCacheSW::InvalidatePages(const uint32* pages, uint32 psm)
 	}
 }
 
+void GSTextureCacheSW::InvalidateVideoMem(const uint32* pages, uint32 psm)
+{
+	// called before the transfer writes the pages, only the first write to a page since the last flush has to do anything
+
+	for(const uint32* p = pages; *p != GSOffset::EOP; p++)
+	{
+		uint32 page = *p;
+
+		uint32 bm = 1 << (page & 31);
+
+		if((m_dirty.bm[page >> 5] & bm) == 0)
+		{
+			m_dirty.bm[page >> 5] |= bm;
+			m_dirty.psm[page][0] = 0;
+			m_dirty.psm[page][1] = 0;
+
+			const list<Texture*>& map = m_map[page];
+
+			for(list<Texture*>::const_iterator i = map.begin(); i != map.end(); i++)
+			{
+				Texture* t = *i;
+
+				if(!t->m_repeating && t->m_valid[page] != 0)
+				{
+					m_dirty.hashed[page >> 5] |= bm;
+					m_dirty.hash[page] = HashPage(&m_state->m_mem.m_vm8[page * PAGE_SIZE]);
+
+					break;
+				}
+			}
+
+			m_dirty.pending = true;
+		}
+
+		m_dirty.psm[page][psm >> 5] |= 1 << (psm & 0x1f);
+	}
+}
+
+void GSTextureCacheSW::FlushDirtyPages()
+{
+	if(!m_dirty.pending)
+	{
+		return;
+	}
+
+	for(size_t i = 0; i < countof(m_dirty.bm); i++)
+	{
+		uint32 p = m_dirty.bm[i];
+
+		uint32 hashed = m_dirty.hashed[i];
+
+		m_dirty.bm[i] = 0;
+		m_dirty.hashed[i] = 0;
+
+		unsigned long j;
+
+		while(_BitScanForward(&j, p))
+		{
+			p ^= 1 << j;
+
+			uint32 page = (i << 5) + j;
+
+			const list<Texture*>& map = m_map[page];
+
+			for(list<Texture*>::const_iterator k = map.begin(); k != map.end(); k++)
+			{
+				Texture* t = *k;
+
+				// same as GSUtil::HasSharedBits for any of the formats the page was written as
+
+				const uint32* RESTRICT psm = m_dirty.psm[page];
+
+				if(((psm[0] & ~t->m_sharedbits[0]) | (psm[1] & ~t->m_sharedbits[1])) == 0)
+				{
+					continue;
+				}
+
+				uint32* RESTRICT valid = t->m_valid;
+
+				if(t->m_repeating)
+				{
+					vector<GSVector2i>& l = t->m_p2t[page];
+
+					for(vector<GSVector2i>::iterator m = l.begin(); m != l.end(); m++)
+					{
+						valid[m->x] &= m->y;
+					}
+				}
+				else
+				{
+					if(valid[page] != 0 && (hashed & (1 << j)))
+					{
+						t->m_revalidate.bm[i] |= 1 << j;
+						t->m_revalidate.valid[page] = valid[page];
+						t->m_revalidate.hash[page] = m_dirty.hash[page];
+					}
+
+					valid[page] = 0;
+				}
+
+				t->m_complete = false;
+			}
+		}
+	}
+
+	m_dirty.pending = false;
+}
+
 void GSTextureCacheSW::RemoveAll()
 {
 	for_each(m_textures.begin(), m_textures.end(), delete_object());
@@ -129,10 +249,17 @@ void GSTextureCacheSW::RemoveAll()
 	{
 		m_map[i].clear();
 	}
+
+	memset(m_dirty.bm, 0, sizeof(m_dirty.bm));
+	memset(m_dirty.hashed, 0, sizeof(m_dirty.hashed));
+
+	m_dirty.pending = false;
 }
 
 void GSTextureCacheSW::IncAge()
 {
+	uint64 size = 0;
+
 	for(hash_set<Texture*>::iterator i = m_textures.begin(); i != m_textures.end(); )
 	{
 		hash_set<Texture*>::iterator j = i++;
@@ -143,21 +270,114 @@ void GSTextureCacheSW::IncAge()
 		{
 			m_textures.erase(j);
 
-			for(const uint32* p = t->m_pages.n; *p != GSOffset::EOP; p++)
-			{
-				list<Texture*>& m = m_map[*p];
+			Remove(t);
+		}
+		else
+		{
+			size += t->m_size;
+		}
+	}
 
-				for(list<Texture*>::iterator i = m.begin(); i != m.end(); )
-				{
-					list<Texture*>::iterator j = i++;
+	if(size > m_budget)
+	{
+		// least recently used first, age is reset by Lookup
 
-					if(*j == t) {m.erase(j); break;}
-				}
-			}
+		vector<Texture*> textures(m_textures.begin(), m_textures.end());
+
+		std::sort(textures.begin(), textures.end(), OlderThan);
+
+		for(vector<Texture*>::iterator i = textures.begin(); i != textures.end() && size > m_budget; i++)
+		{
+			Texture* t = *i;
+
+			size -= t->m_size;
+
+			m_textures.erase(t);
+
+			Remove(t);
+		}
+	}
+}
+
+bool GSTextureCacheSW::OlderThan(const Texture* a, const Texture* b)
+{
+	return a->m_age > b->m_age;
+}
+
+void GSTextureCacheSW::Remove(Texture* t)
+{
+	for(const uint32* p = t->m_pages.n; *p != GSOffset::EOP; p++)
+	{
+		list<Texture*>& m = m_map[*p];
+
+		for(list<Texture*>::iterator i = m.begin(); i != m.end(); )
+		{
+			list<Texture*>::iterator j = i++;
 
-			delete t;
+			if(*j == t) {m.erase(j); break;}
 		}
 	}
+
+	delete t;
+}
+
+// xxHash64 (fixed length, no seed). Revalidate trusts a matching hash, so it needs proper mixing:
+// with a linear hash (like x * 33 ^ data per lane) the same bit flipped in two places can cancel
+// out, and a page the guest modified would be revalidated with stale contents.
+
+#define PRIME64_1 0x9E3779B185EBCA87ULL
+#define PRIME64_2 0xC2B2AE3D27D4EB4FULL
+#define PRIME64_3 0x165667B19E3779F9ULL
+#define PRIME64_4 0x85EBCA77C2B2AE63ULL
+
+static __forceinline uint64 rotl64(uint64 x, int r)
+{
+	return (x << r) | (x >> (64 - r));
+}
+
+static __forceinline uint64 HashRound(uint64 acc, uint64 data)
+{
+	return rotl64(acc + data * PRIME64_2, 31) * PRIME64_1;
+}
+
+static __forceinline uint64 HashMerge(uint64 h, uint64 acc)
+{
+	return (h ^ HashRound(0, acc)) * PRIME64_1 + PRIME64_4;
+}
+
+uint64 GSTextureCacheSW::HashPage(const uint8* RESTRICT src)
+{
+	const uint64* s = (const uint64*)src;
+
+	uint64 v0 = PRIME64_1 + PRIME64_2;
+	uint64 v1 = PRIME64_2;
+	uint64 v2 = 0;
+	uint64 v3 = 0 - PRIME64_1;
+
+	for(size_t i = 0; i < PAGE_SIZE / sizeof(uint64); i += 4)
+	{
+		v0 = HashRound(v0, s[i + 0]);
+		v1 = HashRound(v1, s[i + 1]);
+		v2 = HashRound(v2, s[i + 2]);
+		v3 = HashRound(v3, s[i + 3]);
+	}
+
+	uint64 h = rotl64(v0, 1) + rotl64(v1, 7) + rotl64(v2, 12) + rotl64(v3, 18);
+
+	h = HashMerge(h, v0);
+	h = HashMerge(h, v1);
+	h = HashMerge(h, v2);
+	h = HashMerge(h, v3);
+
+	h += PAGE_SIZE;
+
+	h ^= h >> 33;
+	h *= PRIME64_2;
+	h ^= h >> 29;
+	h *= PRIME64_3;
+	h ^= h >> 32;
+
+	return h;
 }
 
 //
@@ -165,6 +385,7 @@ void GSTextureCacheSW::IncAge()
 GSTextureCacheSW::Texture::Texture(GSState* state, uint32 tw0, const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA)
 	: m_state(state)
 	, m_buff(NULL)
+	, m_size(0)
 	, m_tw(tw0)
 	, m_age(0)
 	, m_complete(false)
@@ -180,6 +401,7 @@ GSTextureCacheSW::Texture::Texture(GSState* state, uint32 tw0, const GIFRegTEX0&
 
 	memset(m_valid, 0, sizeof(m_valid));
 	memset(m_pages.bm, 0, sizeof(m_pages.bm));
+	memset(m_revalidate.bm, 0, sizeof(m_revalidate.bm));
 
 	m_sharedbits = GSUtil::HasSharedBitsPtr(m_TEX0.PSM);
 
@@ -219,6 +441,11 @@ bool GSTextureCacheSW::Texture::Update(const GSVector4i& rect)
 		return true;
 	}
 
+	if(!m_repeating)
+	{
+		Revalidate();
+	}
+
 	const GSLocalMemory::psm_t& psm = GSLocalMemory::m_psm[m_TEX0.PSM];
 
 	GSVector2i bs = psm.bs;
@@ -247,6 +474,8 @@ bool GSTextureCacheSW::Texture::Update(const GSVector4i& rect)
 		{
 			return false;
 		}
+
+		m_size = pitch * th * 4;
 	}
 
 	GSLocalMemory& mem = m_state->m_mem;
@@ -333,6 +562,33 @@ bool GSTextureCacheSW::Texture::Update(const GSVector4i& rect)
 	return true;
 }
 
+void GSTextureCacheSW::Texture::Revalidate()
+{
+	const uint8* RESTRICT vm = m_state->m_mem.m_vm8;
+
+	for(size_t i = 0; i < countof(m_revalidate.bm); i++)
+	{
+		if(uint32 p = m_revalidate.bm[i])
+		{
+			m_revalidate.bm[i] = 0;
+
+			unsigned long j;
+
+			while(_BitScanForward(&j, p))
+			{
+				p ^= 1 << j;
+
+				uint32 page = (i << 5) + j;
+
+				if(GSTextureCacheSW::HashPage(&vm[page * PAGE_SIZE]) == m_revalidate.hash[page])
+				{
+					m_valid[page] |= m_revalidate.valid[page];
+				}
+			}
+		}
+	}
+}
+
 #include "GSTextureSW.h"
 
 bool GSTextureCacheSW::Texture::Save(const string& fn, bool dds) const
@@ -34,6 +34,7 @@ public:
 		GIFRegTEX0 m_TEX0;
 		GIFRegTEXA m_TEXA;
 		void* m_buff;
+		uint32 m_size;
 		uint32 m_tw;
 		uint32 m_age;
 		bool m_complete;
@@ -42,15 +43,21 @@ public:
 		uint32 m_valid[MAX_PAGES];
 		struct {uint32 bm[16]; const uint32* n;} m_pages;
 		const uint32* RESTRICT m_sharedbits;
+		struct {uint32 bm[16]; uint32 valid[MAX_PAGES]; uint64 hash[MAX_PAGES];} m_revalidate;
 
 		// m_valid
 		// fast mode: each uint32 bits map to the 32 blocks of that page
 		// repeating mode: 1 bpp image of the texture tiles (8x8), also having 512 elements is just a coincidence (worst case: (1024*1024)/(8*8)/(sizeof(uint32)*8))
 
+		// m_revalidate (fast mode only)
+		// pages invalidated by transfers keep their old valid bits and the hash of the page before it was overwritten,
+		// if the hash still matches at the next Update the blocks did not change and can be reused without reading them again
+
 		Texture(GSState* state, uint32 tw0, const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA);
 		virtual ~Texture();
 
 		bool Update(const GSVector4i& r);
+		void Revalidate();
 		bool Save(const string& fn, bool dds = false) const;
 	};
 
@@ -58,6 +65,23 @@ protected:
 	GSState* m_state;
 	hash_set<Texture*> m_textures;
 	list<Texture*> m_map[MAX_PAGES];
+	uint64 m_budget;
+
+	// pages written by transfers since the last draw, with the formats they were written as,
+	// and the hash of their contents before the first write if any texture had valid blocks there
+
+	struct
+	{
+		uint32 bm[MAX_PAGES / 32];
+		uint32 hashed[MAX_PAGES / 32];
+		uint32 psm[MAX_PAGES][2];
+		uint64 hash[MAX_PAGES];
+		bool pending;
+	} m_dirty;
+
+	void Remove(Texture* t);
+
+	static bool OlderThan(const Texture* a, const Texture* b);
 
 public:
 	GSTextureCacheSW(GSState* state);
@@ -66,6 +90,10 @@ public:
 	Texture* Lookup(const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA, uint32 tw0 = 0);
 
 	void InvalidatePages(const uint32* pages, uint32 psm);
+	void InvalidateVideoMem(const uint32* pages, uint32 psm);
+	void FlushDirtyPages();
+
+	static uint64 HashPage(const uint8* RESTRICT src);
 
 	void RemoveAll();
 	void IncAge();
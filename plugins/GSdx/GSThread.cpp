@@ -149,3 +149,47 @@ void GSThread::CloseThread()
     #endif
 }
 
+// GSWorkerPool
+
+GSWorkerPool::GSWorkerPool(int threads)
+{
+	for(int i = 0; i < threads; i++)
+	{
+		m_workers.push_back(new GSWorker());
+	}
+}
+
+GSWorkerPool::~GSWorkerPool()
+{
+	for(vector<GSWorker*>::iterator i = m_workers.begin(); i != m_workers.end(); i++)
+	{
+		delete *i;
+	}
+}
+
+void GSWorkerPool::Run(Callback cb, void* param, int count, int align)
+{
+	int parts = GetParts();
+
+	int step = ((count + parts - 1) / parts + align - 1) / align * align;
+
+	for(int i = 1; i < parts; i++)
+	{
+		int begin = i * step;
+		int end = std::min<int>(begin + step, count);
+
+		if(begin >= end) break;
+
+		Job job = {cb, param, i, begin, end};
+
+		m_workers[i - 1]->Push(job);
+	}
+
+	cb(param, 0, 0, std::min<int>(step, count));
+
+	for(size_t i = 0; i < m_workers.size(); i++)
+	{
+		m_workers[i]->Wait();
+	}
+}
+
@@ -370,6 +370,39 @@ public:
 	virtual void Process(T& item) = 0;
 };
 
+// splits a loop over [0, count) into equal parts, the first part runs on the calling thread, returns when all of them are done
+
+class GSWorkerPool
+{
+public:
+	typedef void (*Callback)(void* param, int part, int begin, int end);
+
+protected:
+	struct Job {Callback cb; void* param; int part, begin, end;};
+
+	class GSWorker : public GSJobQueue<Job>
+	{
+	public:
+		virtual ~GSWorker() {Wait();}
+
+		// GSJobQueue
+
+		void Process(Job& job) {job.cb(job.param, job.part, job.begin, job.end);}
+	};
+
+	vector<GSWorker*> m_workers;
+
+public:
+	enum {MinItems = 16384}; // smaller loops are not worth the hand-off to the workers
+
+	GSWorkerPool(int threads);
+	virtual ~GSWorkerPool();
+
+	int GetParts() const {return (int)m_workers.size() + 1;}
+
+	void Run(Callback cb, void* param, int count, int align = 1);
+};
+
 // http://software.intel.com/en-us/blogs/2012/11/06/exploring-intel-transactional-synchronization-extensions-with-intel-software
 
 class TransactionScope
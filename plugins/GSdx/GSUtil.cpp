@@ -193,7 +193,9 @@ bool GSUtil::CheckSSE()
 	Xbyak::util::Cpu cpu;
 	Xbyak::util::Cpu::Type type;
 
-	#if _M_SSE >= 0x500
+	#if _M_SSE >= 0x501
+	type = Xbyak::util::Cpu::tAVX2;
+	#elif _M_SSE >= 0x500
 	type = Xbyak::util::Cpu::tAVX;
 	#elif _M_SSE >= 0x402
 	type = Xbyak::util::Cpu::tSSE42;
@@ -2970,15 +2970,15 @@ public:
 
 	}
 
-	template<int i> __forceinline int extract32() const
+	template<int index> __forceinline int extract32() const
 	{
 		#if _M_SSE >= 0x401
 
-		return _mm_extract_ps(m, i);
+		return _mm_extract_ps(m, index);
 
 		#else
 
-		return i32[i];
+		return i32[index];
 
 		#endif
 	}
@@ -3810,7 +3810,7 @@ public:
 
 	template<int i> __forceinline GSVector8i sll() const
 	{
-		return GSVector8i(_mm256_slli_si128(m, i));
+		return GSVector8i(_mm256_slli_si256(m, i));
 	}
 
 	__forceinline GSVector8i sra16(int i) const
@@ -4260,21 +4260,6 @@ public:
 		return cast(v0).insert<1>(v1);
 	}
 
-	template<> __forceinline GSVector8i gather32_32<uint8>(const uint8* ptr) const
-	{
-		return GSVector8i(_mm256_i32gather_epi32((const int*)ptr, m, 1)) & GSVector8i::x000000ff();
-	}
-
-	template<> __forceinline GSVector8i gather32_32<uint16>(const uint16* ptr) const
-	{
-		return GSVector8i(_mm256_i32gather_epi32((const int*)ptr, m, 2)) & GSVector8i::x0000ffff();
-	}
-
-	template<> __forceinline GSVector8i gather32_32<uint32>(const uint32* ptr) const
-	{
-		return GSVector8i(_mm256_i32gather_epi32((const int*)ptr, m, 4));
-	}
-
 	template<class T1, class T2> __forceinline GSVector8i gather32_32(const T1* ptr1, const T2* ptr2) const
 	{
 		GSVector4i v0;
@@ -4296,19 +4281,14 @@ public:
 		return cast(v0).insert<1>(v1);
 	}
 
-	template<> __forceinline GSVector8i gather32_32<uint8, uint32>(const uint8* ptr1, const uint32* ptr2) const
-	{
-		return gather32_32<uint8>(ptr1).gather32_32<uint32>(ptr2);
-	}
-
-	template<> __forceinline GSVector8i gather32_32<uint32, uint32>(const uint32* ptr1, const uint32* ptr2) const
+	template<class T> __forceinline void gather32_32(const T* RESTRICT ptr, GSVector8i* RESTRICT dst) const
 	{
-		return gather32_32<uint32>(ptr1).gather32_32<uint32>(ptr2);
+		dst[0] = gather32_32<>(ptr);
 	}
 
-	template<class T> __forceinline void gather32_32(const T* RESTRICT ptr, GSVector8i* RESTRICT dst) const
+	__forceinline static GSVector8i gather64_32(const uint64* ptr, const GSVector4i& index)
 	{
-		dst[0] = gather32_32<>(ptr);
+		return GSVector8i(_mm256_i32gather_epi64((const int64*)ptr, index, 8));
 	}
 
 	//
@@ -5073,6 +5053,33 @@ public:
 	__forceinline static GSVector8i x0f(int n) {return m_x0f[n];}
 };
 
+// explicit specializations must be at namespace scope (gcc is strict about this)
+
+template<> __forceinline GSVector8i GSVector8i::gather32_32<uint8>(const uint8* ptr) const
+{
+	return GSVector8i(_mm256_i32gather_epi32((const int*)ptr, m, 1)) & GSVector8i::x000000ff();
+}
+
+template<> __forceinline GSVector8i GSVector8i::gather32_32<uint16>(const uint16* ptr) const
+{
+	return GSVector8i(_mm256_i32gather_epi32((const int*)ptr, m, 2)) & GSVector8i::x0000ffff();
+}
+
+template<> __forceinline GSVector8i GSVector8i::gather32_32<uint32>(const uint32* ptr) const
+{
+	return GSVector8i(_mm256_i32gather_epi32((const int*)ptr, m, 4));
+}
+
+template<> __forceinline GSVector8i GSVector8i::gather32_32<uint8, uint32>(const uint8* ptr1, const uint32* ptr2) const
+{
+	return gather32_32<uint8>(ptr1).gather32_32<uint32>(ptr2);
+}
+
+template<> __forceinline GSVector8i GSVector8i::gather32_32<uint32, uint32>(const uint32* ptr1, const uint32* ptr2) const
+{
+	return gather32_32<uint32>(ptr1).gather32_32<uint32>(ptr2);
+}
+
 #endif
 
 #if _M_SSE >= 0x500
@@ -5549,7 +5556,7 @@ public:
 	{
 		ASSERT(i < 8);
 
-		return extract<i / 4>().extract32<i & 3>();
+		return extract<i / 4>().template extract32<i & 3>();
 	}
 
 	template<int i> __forceinline GSVector8 insert(__m128 m) const
@@ -28,6 +28,8 @@ const GSVector4 GSVertexTrace::s_minmax(FLT_MAX, -FLT_MAX);
 
 GSVertexTrace::GSVertexTrace(const GSState* state)
 	: m_state(state)
+	, m_pool(NULL)
+	, m_mm(NULL)
 {
 	#define InitUpdate3(P, IIP, TME, FST, COLOR) \
 		m_fmm[COLOR][FST][TME][IIP][P] = &GSVertexTrace::FindMinMax<P, IIP, TME, FST, COLOR>;
@@ -50,6 +52,21 @@ GSVertexTrace::GSVertexTrace(const GSState* state)
 	InitUpdate(GS_SPRITE_CLASS);
 }
 
+GSVertexTrace::~GSVertexTrace()
+{
+	_aligned_free(m_mm);
+}
+
+void GSVertexTrace::SetWorkerPool(GSWorkerPool* pool)
+{
+	// the pool is owned by the renderer, large draws are split between its threads
+
+	_aligned_free(m_mm);
+
+	m_pool = pool;
+	m_mm = pool != NULL ? (MinMax*)_aligned_malloc(sizeof(MinMax) * pool->GetParts(), 32) : NULL;
+}
+
 void GSVertexTrace::Update(const void* vertex, const uint32* index, int count, GS_PRIM_CLASS primclass)
 {
 	m_primclass = primclass;
@@ -59,7 +76,100 @@ void GSVertexTrace::Update(const void* vertex, const uint32* index, int count, G
 	uint32 fst = m_state->PRIM->FST;
 	uint32 color = !(m_state->PRIM->TME && m_state->m_context->TEX0.TFX == TFX_DECAL && m_state->m_context->TEX0.TCC);
 
-	(this->*m_fmm[color][fst][tme][iip][primclass])(vertex, index, count);
+	FindMinMaxPtr fmm = m_fmm[color][fst][tme][iip][primclass];
+
+	MinMax mm;
+
+	if(m_pool != NULL && count >= GSWorkerPool::MinItems)
+	{
+		int parts = m_pool->GetParts();
+
+		for(int i = 0; i < parts; i++)
+		{
+			m_mm[i].cmin = GSVector4i::xffffffff();
+			m_mm[i].cmax = GSVector4i::zero();
+			m_mm[i].tmin = s_minmax.xxxx();
+			m_mm[i].tmax = s_minmax.yyyy();
+			#if _M_SSE >= 0x401
+			m_mm[i].pmin = GSVector4i::xffffffff();
+			m_mm[i].pmax = GSVector4i::zero();
+			#else
+			m_mm[i].pmin = s_minmax.xxxx();
+			m_mm[i].pmax = s_minmax.yyyy();
+			#endif
+		}
+
+		FindMinMaxJob job = {this, fmm, vertex, index, m_mm};
+
+		m_pool->Run(FindMinMaxPart, &job, count, primclass == GS_TRIANGLE_CLASS ? 3 : primclass == GS_POINT_CLASS ? 1 : 2);
+
+		mm = m_mm[0];
+
+		for(int i = 1; i < parts; i++)
+		{
+			mm.cmin = mm.cmin.min_u8(m_mm[i].cmin);
+			mm.cmax = mm.cmax.max_u8(m_mm[i].cmax);
+			mm.tmin = mm.tmin.min(m_mm[i].tmin);
+			mm.tmax = mm.tmax.max(m_mm[i].tmax);
+			#if _M_SSE >= 0x401
+			mm.pmin = mm.pmin.min_u32(m_mm[i].pmin);
+			mm.pmax = mm.pmax.max_u32(m_mm[i].pmax);
+			#else
+			mm.pmin = mm.pmin.min(m_mm[i].pmin);
+			mm.pmax = mm.pmax.max(m_mm[i].pmax);
+			#endif
+		}
+	}
+	else
+	{
+		(this->*fmm)(vertex, index, count, mm);
+	}
+
+	const GSDrawingContext* context = m_state->m_context;
+
+	#if _M_SSE >= 0x401
+
+	mm.pmin = mm.pmin.blend16<0x30>(mm.pmin.srl32(1));
+	mm.pmax = mm.pmax.blend16<0x30>(mm.pmax.srl32(1));
+
+	#endif
+
+	GSVector4 o(context->XYOFFSET);
+	GSVector4 s(1.0f / 16, 1.0f / 16, 2.0f, 1.0f);
+
+	m_min.p = (GSVector4(mm.pmin) - o) * s;
+	m_max.p = (GSVector4(mm.pmax) - o) * s;
+
+	if(tme)
+	{
+		if(fst)
+		{
+			s = GSVector4(1.0f / 16, 1.0f).xxyy();
+		}
+		else
+		{
+			s = GSVector4(1 << context->TEX0.TW, 1 << context->TEX0.TH, 1, 1);
+		}
+
+		m_min.t = mm.tmin * s;
+		m_max.t = mm.tmax * s;
+	}
+	else
+	{
+		m_min.t = GSVector4::zero();
+		m_max.t = GSVector4::zero();
+	}
+
+	if(color)
+	{
+		m_min.c = mm.cmin.zzzz().u8to32();
+		m_max.c = mm.cmax.zzzz().u8to32();
+	}
+	else
+	{
+		m_min.c = GSVector4i::zero();
+		m_max.c = GSVector4i::zero();
+	}
 
 	m_eq.value = (m_min.c == m_max.c).mask() | ((m_min.p == m_max.p).mask() << 16) | ((m_min.t == m_max.t).mask() << 20);
 
@@ -110,11 +220,16 @@ void GSVertexTrace::Update(const void* vertex, const uint32* index, int count, G
 	}
 }
 
-template<GS_PRIM_CLASS primclass, uint32 iip, uint32 tme, uint32 fst, uint32 color>
-void GSVertexTrace::FindMinMax(const void* vertex, const uint32* index, int count)
+void GSVertexTrace::FindMinMaxPart(void* param, int part, int begin, int end)
 {
-	const GSDrawingContext* context = m_state->m_context;
+	FindMinMaxJob* job = (FindMinMaxJob*)param;
+
+	(job->vt->*job->fmm)(job->vertex, job->index + begin, end - begin, job->mm[part]);
+}
 
+template<GS_PRIM_CLASS primclass, uint32 iip, uint32 tme, uint32 fst, uint32 color>
+void GSVertexTrace::FindMinMax(const void* vertex, const uint32* index, int count, MinMax& mm)
+{
 	int n = 1;
 
 	switch(primclass)
@@ -438,47 +553,10 @@ void GSVertexTrace::FindMinMax(const void* vertex, const uint32* index, int coun
 		}
 	}
 
-	#if _M_SSE >= 0x401
-
-	pmin = pmin.blend16<0x30>(pmin.srl32(1));
-	pmax = pmax.blend16<0x30>(pmax.srl32(1));
-
-	#endif
-
-	GSVector4 o(context->XYOFFSET);
-	GSVector4 s(1.0f / 16, 1.0f / 16, 2.0f, 1.0f);
-
-	m_min.p = (GSVector4(pmin) - o) * s;
-	m_max.p = (GSVector4(pmax) - o) * s;
-
-	if(tme)
-	{
-		if(fst)
-		{
-			s = GSVector4(1.0f / 16, 1.0f).xxyy();
-		}
-		else
-		{
-			s = GSVector4(1 << context->TEX0.TW, 1 << context->TEX0.TH, 1, 1);
-		}
-
-		m_min.t = tmin * s;
-		m_max.t = tmax * s;
-	}
-	else
-	{
-		m_min.t = GSVector4::zero();
-		m_max.t = GSVector4::zero();
-	}
-
-	if(color)
-	{
-		m_min.c = cmin.zzzz().u8to32();
-		m_max.c = cmax.zzzz().u8to32();
-	}
-	else
-	{
-		m_min.c = GSVector4i::zero();
-		m_max.c = GSVector4i::zero();
-	}
+	mm.cmin = cmin;
+	mm.cmax = cmax;
+	mm.tmin = tmin;
+	mm.tmax = tmax;
+	mm.pmin = pmin;
+	mm.pmax = pmax;
 }
@@ -26,6 +26,7 @@
 #include "GSVertexSW.h"
 #include "GSVertexHW.h"
 #include "GSFunctionMap.h"
+#include "GSThread.h"
 
 class GSState;
 
@@ -40,12 +41,37 @@ protected:
 
 	static const GSVector4 s_minmax;
 
-	typedef void (GSVertexTrace::*FindMinMaxPtr)(const void* vertex, const uint32* index, int count);
+	struct MinMax
+	{
+		GSVector4i cmin, cmax;
+		GSVector4 tmin, tmax;
+		#if _M_SSE >= 0x401
+		GSVector4i pmin, pmax;
+		#else
+		GSVector4 pmin, pmax;
+		#endif
+	};
+
+	typedef void (GSVertexTrace::*FindMinMaxPtr)(const void* vertex, const uint32* index, int count, MinMax& mm);
 
 	FindMinMaxPtr m_fmm[2][2][2][2][4];
 
 	template<GS_PRIM_CLASS primclass, uint32 iip, uint32 tme, uint32 fst, uint32 color>
-	void FindMinMax(const void* vertex, const uint32* index, int count);
+	void FindMinMax(const void* vertex, const uint32* index, int count, MinMax& mm);
+
+	struct FindMinMaxJob
+	{
+		GSVertexTrace* vt;
+		FindMinMaxPtr fmm;
+		const void* vertex;
+		const uint32* index;
+		MinMax* mm;
+	};
+
+	static void FindMinMaxPart(void* param, int part, int begin, int end);
+
+	GSWorkerPool* m_pool;
+	MinMax* m_mm;
 
 public:
 	GS_PRIM_CLASS m_primclass;
@@ -70,9 +96,11 @@ public:
 
 public:
 	GSVertexTrace(const GSState* state);
-	virtual ~GSVertexTrace() {}
+	virtual ~GSVertexTrace();
 
 	void Update(const void* vertex, const uint32* index, int count, GS_PRIM_CLASS primclass);
 
+	void SetWorkerPool(GSWorkerPool* pool);
+
 	bool IsLinear() const {return m_filter.linear;}
 };
@@ -27,6 +27,9 @@ void help()
 	fprintf(stderr, "ARG1 GSdx plugin\n");
 	fprintf(stderr, "ARG2 .gs file\n");
 	fprintf(stderr, "ARG3 Ini directory\n");
+	fprintf(stderr, "\n");
+	fprintf(stderr, "or: ARG1 GSdx plugin, ARG2 --verify\n");
+	fprintf(stderr, "runs the self checks of the plugin (block swizzling, texture cache page hash)\n");
 	exit(1);
 }
 
@@ -40,6 +43,21 @@ int main ( int argc, char *argv[] )
 		help();
 	}
 
+	if (strcmp(argv[2], "--verify") == 0) {
+		__attribute__((stdcall)) int (*GSVerify_ptr)();
+
+		*(void**)(&GSVerify_ptr) = dlsym(handle, "GSVerify");
+		if (GSVerify_ptr == NULL) {
+			fprintf(stderr, "GSVerify not exported by %s\n", argv[1]);
+			dlclose(handle);
+			return 1;
+		}
+
+		int failed = GSVerify_ptr();
+		dlclose(handle);
+		return failed != 0;
+	}
+
 	__attribute__((stdcall)) void (*GSsetSettingsDir_ptr)(const char*);
 	__attribute__((stdcall)) void (*GSReplay_ptr)(char*, int);
 
@@ -224,16 +224,21 @@ void V_Core::PlainDMAWrite(u16 *pMem, u32 size)
 		buff1end = 0x100000;
 	}
 
-	const int cacheIdxStart = TSA / pcm_WordsPerBlock;
-	const int cacheIdxEnd = (buff1end+pcm_WordsPerBlock-1) / pcm_WordsPerBlock;
-	PcmCacheEntry* cacheLine = &pcm_cache_data[cacheIdxStart];
-	PcmCacheEntry& cacheEnd = pcm_cache_data[cacheIdxEnd];
+	// Only invalidate the cached blocks whose contents actually change.  Games commonly upload
+	// the same sample banks again (scene changes, streaming rings), and those blocks would
+	// otherwise be decoded all over again by the mixer.
 
-	do
+	const u32 cacheIdxStart = TSA / pcm_WordsPerBlock;
+	const u32 cacheIdxEnd = (buff1end+pcm_WordsPerBlock-1) / pcm_WordsPerBlock;
+
+	for( u32 cacheIdx = cacheIdxStart; cacheIdx < cacheIdxEnd; cacheIdx++ )
 	{
-		cacheLine->Validated = false;
-		cacheLine++;
-	} while ( cacheLine != &cacheEnd );
+		const u32 start = std::max<u32>( cacheIdx * pcm_WordsPerBlock, TSA );
+		const u32 end = std::min<u32>( (cacheIdx + 1) * pcm_WordsPerBlock, buff1end );
+
+		if( memcmp( GetMemPtr( start ), &pMem[start - TSA], (end - start) * 2 ) != 0 )
+			pcm_cache_data[cacheIdx].Validated = false;
+	}
 
 	//ConLog( "* SPU2-X: Cache Clear Range!  TSA=0x%x, TDA=0x%x (low8=0x%x, high8=0x%x, len=0x%x)\n",
 	//	TSA, buff1end, flagTSA, flagTDA, clearLen );
@@ -0,0 +1,169 @@
+/* SPU2-X, A plugin for Emulating the Sound Processing Unit of the Playstation 2
+ * Developed and maintained by the Pcsx2 Development Team.
+ *
+ * SPU2-X is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Found-
+ * ation, either version 3 of the License, or (at your option) any later version.
+ *
+ * SPU2-X is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SPU2-X.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Runs a recorded .s2r stream through the plugin's headless replay (s2r_replay_headless),
+// without starting the emulator.  Exits with a non-zero status if the replay fails, which
+// includes the SSE2 voice mixer differing from the scalar reference in --compare mode, and
+// the span mixer giving a different wav file than mixing one sample at a time in
+// --check-spans mode.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dlfcn.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <string>
+
+// Same values as VoiceMixerType, in Mixer.h
+enum
+{
+	VoiceMixer_SSE2 = 0,
+	VoiceMixer_Scalar,
+	VoiceMixer_Compare,
+};
+
+void help()
+{
+	fprintf(stderr, "Loader s2r file\n");
+	fprintf(stderr, "ARG1 SPU2-X plugin\n");
+	fprintf(stderr, "ARG2 .s2r file\n");
+	fprintf(stderr, "ARG3 .wav file the mix is recorded to\n");
+	fprintf(stderr, "then any of:\n");
+	fprintf(stderr, "--scalar    mix the voices with the scalar reference instead of the SSE2 kernel\n");
+	fprintf(stderr, "--compare   run both voice mixers and fail if they differ\n");
+	fprintf(stderr, "--no-spans  mix one sample at a time\n");
+	fprintf(stderr, "--check-spans  also replay one sample at a time (to ARG3.nospans.wav), and fail if the wav files differ\n");
+	exit(1);
+}
+
+typedef double (*s2r_replay_headless_fn)(const char*, const char*, int, int);
+
+// Replays in a child process, so that the replay after it starts from a freshly loaded plugin.
+static bool replay_forked(s2r_replay_headless_fn replay, const char* s2rfile, const char* wavfile, int mixer, int spans)
+{
+	pid_t pid = fork();
+	if (pid < 0) {
+		perror("fork");
+		return false;
+	}
+
+	if (pid == 0)
+		_exit(replay(s2rfile, wavfile, mixer, spans) < 0 ? 1 : 0);
+
+	int status = 0;
+	if (waitpid(pid, &status, 0) < 0) {
+		perror("waitpid");
+		return false;
+	}
+
+	return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+// Returns the offset of the first byte that differs, or -1 if both files are the same.
+static long compare_files(const char* name1, const char* name2)
+{
+	FILE* file1 = fopen(name1, "rb");
+	FILE* file2 = fopen(name2, "rb");
+	long offset = 0;
+
+	if (file1 == NULL || file2 == NULL) {
+		fprintf(stderr, "Could not open %s\n", file1 == NULL ? name1 : name2);
+		offset = 0;
+	} else {
+		for (;; offset++) {
+			int c1 = fgetc(file1);
+			int c2 = fgetc(file2);
+
+			if (c1 != c2) break;
+			if (c1 == EOF) {
+				offset = -1;
+				break;
+			}
+		}
+	}
+
+	if (file1) fclose(file1);
+	if (file2) fclose(file2);
+
+	return offset;
+}
+
+int main ( int argc, char *argv[] )
+{
+	if (argc < 4) help();
+
+	int mixer = VoiceMixer_SSE2;
+	int spans = 1;
+	bool check_spans = false;
+
+	for (int i = 4; i < argc; i++) {
+		if (strcmp(argv[i], "--scalar") == 0)
+			mixer = VoiceMixer_Scalar;
+		else if (strcmp(argv[i], "--compare") == 0)
+			mixer = VoiceMixer_Compare;
+		else if (strcmp(argv[i], "--no-spans") == 0)
+			spans = 0;
+		else if (strcmp(argv[i], "--check-spans") == 0)
+			check_spans = true;
+		else {
+			fprintf(stderr, "Unknown option %s\n", argv[i]);
+			help();
+		}
+	}
+
+	void *handle = dlopen(argv[1], RTLD_LAZY|RTLD_GLOBAL);
+	if (handle == NULL) {
+		fprintf(stderr, "Failed to dlopen plugin %s: %s\n", argv[1], dlerror());
+		help();
+	}
+
+	s2r_replay_headless_fn s2r_replay_headless_ptr;
+
+	*(void**)(&s2r_replay_headless_ptr) = dlsym(handle, "s2r_replay_headless");
+	if (s2r_replay_headless_ptr == NULL) {
+		fprintf(stderr, "s2r_replay_headless not exported by %s\n", argv[1]);
+		dlclose(handle);
+		return 1;
+	}
+
+	const std::string nospans_wav = std::string(argv[3]) + ".nospans.wav";
+
+	if (check_spans && !replay_forked(s2r_replay_headless_ptr, argv[2], nospans_wav.c_str(), mixer, 0)) {
+		fprintf(stderr, "Replay of %s without spans failed\n", argv[2]);
+		dlclose(handle);
+		return 1;
+	}
+
+	double rate = s2r_replay_headless_ptr(argv[2], argv[3], mixer, spans);
+	dlclose(handle);
+
+	if (rate < 0) {
+		fprintf(stderr, "Replay of %s failed\n", argv[2]);
+		return 1;
+	}
+
+	if (check_spans) {
+		long offset = compare_files(argv[3], nospans_wav.c_str());
+		if (offset >= 0) {
+			fprintf(stderr, "%s and %s differ at byte %ld\n", argv[3], nospans_wav.c_str(), offset);
+			return 1;
+		}
+		printf("Mixing in spans and one sample at a time gave the same wav file\n");
+	}
+
+	printf("%.0f samples/sec\n", rate);
+	return 0;
+}
@@ -17,6 +17,9 @@
 
 #include "Global.h"
 
+#include <emmintrin.h>
+#include <algorithm>
+
 // Games have turned out to be surprisingly sensitive to whether a parked, silent voice is being fully emulated.
 // With Silent Hill: Shattered Memories requiring full processing for no obvious reason, we've decided to
 // disable the optimisation until we can tie it to the game database.
@@ -87,19 +90,42 @@ static void __forceinline XA_decode_block(s16* buffer, const s16* block, s32& pr
 	const s32 pred1 = tbl_XA_Factor[id][0];
 	const s32 pred2 = tbl_XA_Factor[id][1];
 
-	const s8* blockbytes	= (s8*)&block[1];
-	const s8* blockend		= &blockbytes[13];
+	// Unpack and shift all 28 nibbles at once, only the prediction filter has to run sample
+	// by sample.  Each nibble ends up in the top four bits of a 32 bit lane (low nibble of a
+	// byte first), exactly like the ((byte<<28) & 0xF0000000) of the scalar decoder.
+
+	__aligned16 s32 data[32];
+
+	const __m128i bytes	= _mm_srli_si128( _mm_loadu_si128( (const __m128i*)block ), 2 );
+	const __m128i lo	= _mm_and_si128( _mm_slli_epi16( bytes, 4 ), _mm_set1_epi8( (char)0xF0 ) );
+	const __m128i hi	= _mm_and_si128( bytes, _mm_set1_epi8( (char)0xF0 ) );
+	const __m128i cnt	= _mm_cvtsi32_si128( shift );
+	const __m128i zero	= _mm_setzero_si128();
+
+	const __m128i n0 = _mm_unpacklo_epi8( lo, hi );	// nibbles 0-15 as bytes
+	const __m128i n1 = _mm_unpackhi_epi8( lo, hi );	// nibbles 16-31 (28-31 unused)
 
-	for(; blockbytes<=blockend; ++blockbytes)
+	const __m128i w0 = _mm_unpacklo_epi8( zero, n0 );
+	const __m128i w1 = _mm_unpackhi_epi8( zero, n0 );
+	const __m128i w2 = _mm_unpacklo_epi8( zero, n1 );
+	const __m128i w3 = _mm_unpackhi_epi8( zero, n1 );
+
+	_mm_store_si128( (__m128i*)&data[0], _mm_sra_epi32( _mm_unpacklo_epi16( zero, w0 ), cnt ) );
+	_mm_store_si128( (__m128i*)&data[4], _mm_sra_epi32( _mm_unpackhi_epi16( zero, w0 ), cnt ) );
+	_mm_store_si128( (__m128i*)&data[8], _mm_sra_epi32( _mm_unpacklo_epi16( zero, w1 ), cnt ) );
+	_mm_store_si128( (__m128i*)&data[12], _mm_sra_epi32( _mm_unpackhi_epi16( zero, w1 ), cnt ) );
+	_mm_store_si128( (__m128i*)&data[16], _mm_sra_epi32( _mm_unpacklo_epi16( zero, w2 ), cnt ) );
+	_mm_store_si128( (__m128i*)&data[20], _mm_sra_epi32( _mm_unpackhi_epi16( zero, w2 ), cnt ) );
+	_mm_store_si128( (__m128i*)&data[24], _mm_sra_epi32( _mm_unpacklo_epi16( zero, w3 ), cnt ) );
+
+	for( int i=0; i<pcm_DecodedSamplesPerBlock; i+=2 )
 	{
-		s32 data	= ((*blockbytes)<<28) & 0xF0000000;
-		s32 pcm		= (data >> shift) + (((pred1*prev1)+(pred2*prev2)+32) >> 6);
+		s32 pcm		= data[i] + (((pred1*prev1)+(pred2*prev2)+32) >> 6);
 
 		Clampify( pcm, -0x8000, 0x7fff );
 		*(buffer++) = pcm;
 
-		data		= ((*blockbytes)<<24) & 0xF0000000;
-		s32 pcm2	= (data >> shift) + (((pred1*pcm)+(pred2*prev1)+32) >> 6);
+		s32 pcm2	= data[i+1] + (((pred1*pcm)+(pred2*prev1)+32) >> 6);
 
 		Clampify( pcm2, -0x8000, 0x7fff );
 		*(buffer++) = pcm2;
@@ -339,7 +365,8 @@ static __forceinline StereoOut32 ApplyVolume( const StereoOut32& data, const V_V
 	);
 }
 
-static void __forceinline UpdatePitch( uint coreidx, uint voiceidx )
+// The modulator is the OutX of the previous voice, for the same sample.
+static void __forceinline UpdatePitch( uint coreidx, uint voiceidx, s32 modulator )
 {
 	V_Voice& vc( Cores[coreidx].Voices[voiceidx] );
 	s32 pitch;
@@ -351,7 +378,7 @@ static void __forceinline UpdatePitch( uint coreidx, uint voiceidx )
 	if( (vc.Modulated==0) || (voiceidx==0) )
 		pitch = vc.Pitch;
 	else
-		pitch = GetClamped((vc.Pitch*(32768 + Cores[coreidx].Voices[voiceidx-1].OutX))>>15, 0, 0x3fff);
+		pitch = GetClamped((vc.Pitch*(32768 + modulator))>>15, 0, 0x3fff);
 
 	vc.SP+=pitch;
 }
@@ -453,11 +480,10 @@ static s32 CubicInterpolate(
 	return(val + (y1<<1));
 }
 
-// Returns a 16 bit result in Value.
-// Uses standard template-style optimization techniques to statically generate five different
-// versions of this function (one for each type of interpolation).
+// Advances the voice to its current sample position, decoding new blocks as needed.  The
+// interpolation itself is done for several voices at once by MixVoiceBatch.
 template< int InterpType >
-static __forceinline s32 GetVoiceValues( V_Core& thiscore, uint voiceidx )
+static __forceinline void FetchVoiceValues( V_Core& thiscore, uint voiceidx )
 {
 	V_Voice& vc( thiscore.Voices[voiceidx] );
 
@@ -472,22 +498,6 @@ static __forceinline s32 GetVoiceValues( V_Core& thiscore, uint voiceidx )
 		vc.PV1 = GetNextDataBuffered( thiscore, voiceidx );
 		vc.SP -= 4096;
 	}
-
-	const s32 mu = vc.SP + 4096;
-
-	switch( InterpType )
-	{
-		case 0: return vc.PV1<<1;
-		case 1: return (vc.PV1<<1) - (( (vc.PV2 - vc.PV1) * vc.SP)>>11);
-
-		case 2: return CubicInterpolate				(vc.PV4, vc.PV3, vc.PV2, vc.PV1, mu);
-		case 3: return HermiteInterpolate<16384>	(vc.PV4, vc.PV3, vc.PV2, vc.PV1, mu);
-		case 4: return CatmullRomInterpolate		(vc.PV4, vc.PV3, vc.PV2, vc.PV1, mu);
-
-		jNO_DEFAULT;
-	}
-
-	return 0;		// technically unreachable!
 }
 
 // Noise values need to be mixed without going through interpolation, since it
@@ -506,7 +516,7 @@ static __forceinline s32 GetNoiseValues( V_Core& thiscore, uint voiceidx )
 	}*/
 
 	// GetNoiseValues can't set the phase zero on us unexpectedly
-	// like GetVoiceValues can.  Better assert just in case though..
+	// like FetchVoiceValues can.  Better assert just in case though..
 	jASSUME( vc.ADSR.Phase != 0 );
 
 	return retval;
@@ -538,7 +548,32 @@ static __forceinline void spu2M_WriteFast( u32 addr, s16 value )
 }
 
 
-static __forceinline StereoOut32 MixVoice( uint coreidx, uint voiceidx )
+// Voice state gathered by PrepareVoice, one lane per voice.  Everything that has side effects or depends
+// on the previous voice (pitch modulation, sample fetch, ADSR, IRQs, write-back) stays in the scalar
+// pass, the arithmetic that only depends on the voice itself is left to MixVoiceBatch.
+struct VoiceBatch
+{
+	s32 PV4[V_Core::NumVoices];
+	s32 PV3[V_Core::NumVoices];
+	s32 PV2[V_Core::NumVoices];
+	s32 PV1[V_Core::NumVoices];
+	s32 SP[V_Core::NumVoices];
+	s32 Noise[V_Core::NumVoices];		// noise sample, used instead of the interpolated one where NoiseMask is set
+	s32 NoiseMask[V_Core::NumVoices];
+	s32 ADSR[V_Core::NumVoices];		// zero for voices that are off, which makes their output zero
+	s32 VolL[V_Core::NumVoices];
+	s32 VolR[V_Core::NumVoices];
+	s32 DryL[V_Core::NumVoices];
+	s32 DryR[V_Core::NumVoices];
+	s32 WetL[V_Core::NumVoices];
+	s32 WetR[V_Core::NumVoices];
+	s32 OutX[V_Core::NumVoices];		// the voice's OutX after this sample, for pitch modulation of the next one
+};
+
+static __aligned16 VoiceBatch s_VoiceBatch[MixSpanMax];
+
+template< int InterpType >
+static __forceinline void PrepareVoice( VoiceBatch& batch, uint coreidx, uint voiceidx, uint outpos )
 {
 	V_Core& thiscore( Cores[coreidx] );
 	V_Voice& vc( thiscore.Voices[voiceidx] );
@@ -553,45 +588,49 @@ static __forceinline StereoOut32 MixVoice( uint coreidx, uint voiceidx )
 
 	vc.Volume.Update();
 
+	batch.VolL[voiceidx] = vc.Volume.Left.Value;
+	batch.VolR[voiceidx] = vc.Volume.Right.Value;
+
+	batch.DryL[voiceidx] = thiscore.VoiceGates[voiceidx].DryL;
+	batch.DryR[voiceidx] = thiscore.VoiceGates[voiceidx].DryR;
+	batch.WetL[voiceidx] = thiscore.VoiceGates[voiceidx].WetL;
+	batch.WetR[voiceidx] = thiscore.VoiceGates[voiceidx].WetR;
+
 	// SPU2 Note: The spu2 continues to process voices for eternity, always, so we
 	// have to run through all the motions of updating the voice regardless of it's
 	// audible status.  Otherwise IRQs might not trigger and emulation might fail.
 
 	if( vc.ADSR.Phase > 0 )
 	{
-		UpdatePitch( coreidx, voiceidx );
-
-		s32 Value = 0;
+		UpdatePitch( coreidx, voiceidx, voiceidx ? batch.OutX[voiceidx-1] : 0 );
 
 		if( vc.Noise )
-			Value = GetNoiseValues( thiscore, voiceidx );
+		{
+			batch.Noise[voiceidx] = GetNoiseValues( thiscore, voiceidx );
+			batch.NoiseMask[voiceidx] = -1;
+		}
 		else
 		{
-			// Optimization : Forceinline'd Templated Dispatch Table.  Any halfwit compiler will
-			// turn this into a clever jump dispatch table (no call/rets, no compares, uber-efficient!)
-
-			switch( Interpolation )
-			{
-				case 0: Value = GetVoiceValues<0>( thiscore, voiceidx ); break;
-				case 1: Value = GetVoiceValues<1>( thiscore, voiceidx ); break;
-				case 2: Value = GetVoiceValues<2>( thiscore, voiceidx ); break;
-				case 3: Value = GetVoiceValues<3>( thiscore, voiceidx ); break;
-				case 4: Value = GetVoiceValues<4>( thiscore, voiceidx ); break;
-
-				jNO_DEFAULT;
-			}
+			FetchVoiceValues<InterpType>( thiscore, voiceidx );
+			batch.NoiseMask[voiceidx] = 0;
 		}
 
-		// Update and Apply ADSR  (applies to normal and noise sources)
+		batch.PV4[voiceidx] = vc.PV4;
+		batch.PV3[voiceidx] = vc.PV3;
+		batch.PV2[voiceidx] = vc.PV2;
+		batch.PV1[voiceidx] = vc.PV1;
+		batch.SP[voiceidx] = vc.SP;
+
+		// Update ADSR  (applies to normal and noise sources)
 		//
 		// Note!  It's very important that ADSR stay as accurate as possible.  By the way
 		// it is used, various sound effects can end prematurely if we truncate more than
 		// one or two bits.  Best result comes from no truncation at all, which is why we
-		// use a full 64-bit multiply/result here.
+		// use a full 64-bit multiply/result when applying it.
 
 		CalculateADSR( thiscore, voiceidx );
-		Value	= MulShr32( Value, vc.ADSR.Value );
-		
+		batch.ADSR[voiceidx] = vc.ADSR.Value;
+
 		// Store Value for eventual modulation later
 		// Pseudonym's Crest calculation idea. Actually calculates a crest, unlike the old code which was just peak.
 		if(vc.PV1 < vc.NextCrest)
@@ -609,10 +648,8 @@ static __forceinline StereoOut32 MixVoice( uint coreidx, uint voiceidx )
 
 		// Write-back of raw voice data (post ADSR applied)
 
-		if (voiceidx==1)      spu2M_WriteFast( ( (0==coreidx) ? 0x400 : 0xc00 ) + OutPos, vc.OutX );
-		else if (voiceidx==3) spu2M_WriteFast( ( (0==coreidx) ? 0x600 : 0xe00 ) + OutPos, vc.OutX );
-			
-		return ApplyVolume( StereoOut32( Value, Value ), vc.Volume );
+		if (voiceidx==1)      spu2M_WriteFast( ( (0==coreidx) ? 0x400 : 0xc00 ) + outpos, vc.OutX );
+		else if (voiceidx==3) spu2M_WriteFast( ( (0==coreidx) ? 0x600 : 0xe00 ) + outpos, vc.OutX );
 	}
 	else
 	{
@@ -623,36 +660,282 @@ static __forceinline StereoOut32 MixVoice( uint coreidx, uint voiceidx )
 			|| (Cores[1].IRQEnable && (Cores[1].IRQA & ~7) == vc.LoopStartA)
 			|| !(thiscore.Regs.ENDX & 1 << voiceidx))						// or isn't currently flagged as having passed the endpoint
 		{
-			UpdatePitch(coreidx, voiceidx);
+			UpdatePitch(coreidx, voiceidx, voiceidx ? batch.OutX[voiceidx-1] : 0);
 
 			while (vc.SP > 0)
 				GetNextDataDummy(thiscore, voiceidx); // Dummy is enough
 		}
 
 		// Write-back of raw voice data (some zeros since the voice is "dead")
-		if (voiceidx==1)      spu2M_WriteFast( ( (0==coreidx) ? 0x400 : 0xc00 ) + OutPos, 0 );
-		else if (voiceidx==3) spu2M_WriteFast( ( (0==coreidx) ? 0x600 : 0xe00 ) + OutPos, 0 );
+		if (voiceidx==1)      spu2M_WriteFast( ( (0==coreidx) ? 0x400 : 0xc00 ) + outpos, 0 );
+		else if (voiceidx==3) spu2M_WriteFast( ( (0==coreidx) ? 0x600 : 0xe00 ) + outpos, 0 );
 
-		return StereoOut32( 0, 0 );
+		batch.NoiseMask[voiceidx] = -1;
+		batch.Noise[voiceidx] = 0;
+		batch.ADSR[voiceidx] = 0;
 	}
+
+	batch.OutX[voiceidx] = vc.OutX;
 }
 
-const VoiceMixSet VoiceMixSet::Empty( (StereoOut32()), (StereoOut32()) );	// Don't use SteroOut32::Empty because C++ doesn't make any dep/order checks on global initializers.
+// SSE2 equivalents of the 32-bit integer math used by the scalar mixer.  Results are identical to
+// the scalar code, including wrap-around.
 
-static __forceinline void MixCoreVoices( VoiceMixSet& dest, const uint coreidx )
+// low 32 bits of a 32x32 multiply (pmulld is SSE4.1)
+static __forceinline __m128i mul32( __m128i a, __m128i b )
 {
-	V_Core& thiscore( Cores[coreidx] );
+	__m128i even = _mm_mul_epu32( a, b );
+	__m128i odd = _mm_mul_epu32( _mm_srli_epi64( a, 32 ), _mm_srli_epi64( b, 32 ) );
+
+	return _mm_unpacklo_epi32( _mm_shuffle_epi32( even, _MM_SHUFFLE(0,0,2,0) ), _mm_shuffle_epi32( odd, _MM_SHUFFLE(0,0,2,0) ) );
+}
+
+// MulShr32: high 32 bits of a signed 32x32 multiply, from the unsigned product
+static __forceinline __m128i mulshr32( __m128i a, __m128i b )
+{
+	__m128i even = _mm_mul_epu32( a, b );
+	__m128i odd = _mm_mul_epu32( _mm_srli_epi64( a, 32 ), _mm_srli_epi64( b, 32 ) );
+
+	__m128i hi = _mm_unpacklo_epi32( _mm_shuffle_epi32( even, _MM_SHUFFLE(0,0,3,1) ), _mm_shuffle_epi32( odd, _MM_SHUFFLE(0,0,3,1) ) );
+
+	hi = _mm_sub_epi32( hi, _mm_and_si128( _mm_srai_epi32( a, 31 ), b ) );
+	hi = _mm_sub_epi32( hi, _mm_and_si128( _mm_srai_epi32( b, 31 ), a ) );
+
+	return hi;
+}
+
+static __forceinline s32 hsum32( __m128i v )
+{
+	v = _mm_add_epi32( v, _mm_shuffle_epi32( v, _MM_SHUFFLE(1,0,3,2) ) );
+	v = _mm_add_epi32( v, _mm_shuffle_epi32( v, _MM_SHUFFLE(2,3,0,1) ) );
+
+	return _mm_cvtsi128_si32( v );
+}
+
+template< int InterpType >
+static __forceinline __m128i InterpolateVoices( const VoiceBatch& batch, uint i )
+{
+	// y0..y3 and mu as in CubicInterpolate and friends
+
+	const __m128i y0 = _mm_load_si128( (const __m128i*)&batch.PV4[i] );
+	const __m128i y1 = _mm_load_si128( (const __m128i*)&batch.PV3[i] );
+	const __m128i y2 = _mm_load_si128( (const __m128i*)&batch.PV2[i] );
+	const __m128i y3 = _mm_load_si128( (const __m128i*)&batch.PV1[i] );
+	const __m128i sp = _mm_load_si128( (const __m128i*)&batch.SP[i] );
+	const __m128i mu = _mm_add_epi32( sp, _mm_set1_epi32( 4096 ) );
+
+	switch( InterpType )
+	{
+		case 0: return _mm_slli_epi32( y3, 1 );
+		case 1: return _mm_sub_epi32( _mm_slli_epi32( y3, 1 ), _mm_srai_epi32( mul32( _mm_sub_epi32( y2, y3 ), sp ), 11 ) );
+
+		case 2:
+		{
+			const __m128i a0 = _mm_add_epi32( _mm_sub_epi32( _mm_sub_epi32( y3, y2 ), y0 ), y1 );
+			const __m128i a1 = _mm_sub_epi32( _mm_sub_epi32( y0, y1 ), a0 );
+			const __m128i a2 = _mm_sub_epi32( y2, y0 );
+
+			__m128i val = _mm_srai_epi32( mul32( a0, mu ), 12 );
+			val = _mm_srai_epi32( mul32( _mm_add_epi32( val, a1 ), mu ), 12 );
+			val = _mm_srai_epi32( mul32( _mm_add_epi32( val, a2 ), mu ), 11 );
+
+			return _mm_add_epi32( val, _mm_slli_epi32( y1, 1 ) );
+		}
+
+		case 3:
+		{
+			// HermiteInterpolate<16384>, x * 16384 >> 16 == x << 14 >> 16
+
+			const __m128i m00 = _mm_srai_epi32( _mm_slli_epi32( _mm_sub_epi32( y1, y0 ), 14 ), 16 );
+			const __m128i m01 = _mm_srai_epi32( _mm_slli_epi32( _mm_sub_epi32( y2, y1 ), 14 ), 16 );
+			const __m128i m11 = _mm_srai_epi32( _mm_slli_epi32( _mm_sub_epi32( y3, y2 ), 14 ), 16 );
+			const __m128i m0 = _mm_add_epi32( m00, m01 );
+			const __m128i m1 = _mm_add_epi32( m01, m11 );
+
+			__m128i val = _mm_add_epi32( _mm_add_epi32( _mm_slli_epi32( y1, 1 ), m0 ), _mm_sub_epi32( m1, _mm_slli_epi32( y2, 1 ) ) );
+			val = _mm_srai_epi32( mul32( val, mu ), 12 );
+			val = _mm_sub_epi32( _mm_sub_epi32( val, mul32( y1, _mm_set1_epi32( 3 ) ) ), _mm_add_epi32( _mm_slli_epi32( m0, 1 ), m1 ) );
+			val = _mm_srai_epi32( mul32( _mm_add_epi32( val, mul32( y2, _mm_set1_epi32( 3 ) ) ), mu ), 12 );
+			val = _mm_srai_epi32( mul32( _mm_add_epi32( val, m0 ), mu ), 11 );
+
+			return _mm_add_epi32( val, _mm_slli_epi32( y1, 1 ) );
+		}
+
+		case 4:
+		{
+			const __m128i y1x3 = mul32( y1, _mm_set1_epi32( 3 ) );
+			const __m128i y2x3 = mul32( y2, _mm_set1_epi32( 3 ) );
+
+			const __m128i a3 = _mm_add_epi32( _mm_sub_epi32( _mm_sub_epi32( y1x3, y0 ), y2x3 ), y3 );
+			const __m128i a2 = _mm_sub_epi32( _mm_add_epi32( _mm_sub_epi32( _mm_slli_epi32( y0, 1 ), mul32( y1, _mm_set1_epi32( 5 ) ) ), _mm_slli_epi32( y2, 2 ) ), y3 );
+			const __m128i a1 = _mm_sub_epi32( y2, y0 );
+			const __m128i a0 = _mm_slli_epi32( y1, 1 );
+
+			__m128i val = _mm_srai_epi32( mul32( a3, mu ), 12 );
+			val = _mm_srai_epi32( mul32( _mm_add_epi32( a2, val ), mu ), 12 );
+			val = _mm_srai_epi32( mul32( _mm_add_epi32( a1, val ), mu ), 12 );
+
+			return _mm_add_epi32( a0, val );
+		}
+
+		jNO_DEFAULT;
+	}
+
+	return _mm_setzero_si128();		// technically unreachable!
+}
+
+// Interpolation, ADSR, volume and the voice gates for four voices at a time.
+template< int InterpType >
+static __forceinline void MixVoiceBatch( VoiceMixSet& dest, const VoiceBatch& batch )
+{
+	__m128i dryl = _mm_setzero_si128();
+	__m128i dryr = _mm_setzero_si128();
+	__m128i wetl = _mm_setzero_si128();
+	__m128i wetr = _mm_setzero_si128();
+
+	for( uint i=0; i<V_Core::NumVoices; i+=4 )
+	{
+		const __m128i mask = _mm_load_si128( (const __m128i*)&batch.NoiseMask[i] );
+
+		__m128i value = InterpolateVoices<InterpType>( batch, i );
+
+		value = _mm_or_si128( _mm_andnot_si128( mask, value ), _mm_and_si128( mask, _mm_load_si128( (const __m128i*)&batch.Noise[i] ) ) );
+		value = mulshr32( value, _mm_load_si128( (const __m128i*)&batch.ADSR[i] ) );
+
+		// ApplyVolume
+
+		value = _mm_slli_epi32( value, 1 );
+
+		const __m128i l = mulshr32( value, _mm_load_si128( (const __m128i*)&batch.VolL[i] ) );
+		const __m128i r = mulshr32( value, _mm_load_si128( (const __m128i*)&batch.VolR[i] ) );
+
+		// Note: Results are ranged at 16 bits.
+
+		dryl = _mm_add_epi32( dryl, _mm_and_si128( l, _mm_load_si128( (const __m128i*)&batch.DryL[i] ) ) );
+		dryr = _mm_add_epi32( dryr, _mm_and_si128( r, _mm_load_si128( (const __m128i*)&batch.DryR[i] ) ) );
+		wetl = _mm_add_epi32( wetl, _mm_and_si128( l, _mm_load_si128( (const __m128i*)&batch.WetL[i] ) ) );
+		wetr = _mm_add_epi32( wetr, _mm_and_si128( r, _mm_load_si128( (const __m128i*)&batch.WetR[i] ) ) );
+	}
+
+	dest.Dry.Left	+= hsum32( dryl );
+	dest.Dry.Right	+= hsum32( dryr );
+	dest.Wet.Left	+= hsum32( wetl );
+	dest.Wet.Right	+= hsum32( wetr );
+}
+
+// Scalar reference for MixVoiceBatch: the voice mixer as it was before the SSE2 kernel, working
+// on the same prepared batch.  Only used when checking the kernel (see VoiceMixer).
+template< int InterpType >
+static __forceinline s32 InterpolateVoice( const VoiceBatch& batch, uint voiceidx )
+{
+	const s32 PV4 = batch.PV4[voiceidx];
+	const s32 PV3 = batch.PV3[voiceidx];
+	const s32 PV2 = batch.PV2[voiceidx];
+	const s32 PV1 = batch.PV1[voiceidx];
+	const s32 SP = batch.SP[voiceidx];
+	const s32 mu = SP + 4096;
+
+	switch( InterpType )
+	{
+		case 0: return PV1<<1;
+		case 1: return (PV1<<1) - (( (PV2 - PV1) * SP)>>11);
+
+		case 2: return CubicInterpolate				(PV4, PV3, PV2, PV1, mu);
+		case 3: return HermiteInterpolate<16384>	(PV4, PV3, PV2, PV1, mu);
+		case 4: return CatmullRomInterpolate		(PV4, PV3, PV2, PV1, mu);
+
+		jNO_DEFAULT;
+	}
+
+	return 0;		// technically unreachable!
+}
+
+template< int InterpType >
+static void MixVoiceBatchScalar( VoiceMixSet& dest, const VoiceBatch& batch )
+{
+	for( uint voiceidx=0; voiceidx<V_Core::NumVoices; ++voiceidx )
+	{
+		s32 Value = batch.NoiseMask[voiceidx] ? batch.Noise[voiceidx] : InterpolateVoice<InterpType>( batch, voiceidx );
+
+		Value = MulShr32( Value, batch.ADSR[voiceidx] );
+
+		const StereoOut32 VVal( ApplyVolume( Value, batch.VolL[voiceidx] ), ApplyVolume( Value, batch.VolR[voiceidx] ) );
 
+		// Note: Results are ranged at 16 bits.
+
+		dest.Dry.Left	+= VVal.Left	& batch.DryL[voiceidx];
+		dest.Dry.Right	+= VVal.Right	& batch.DryR[voiceidx];
+		dest.Wet.Left	+= VVal.Left	& batch.WetL[voiceidx];
+		dest.Wet.Right	+= VVal.Right	& batch.WetR[voiceidx];
+	}
+}
+
+int VoiceMixer = VoiceMixer_SSE2;
+u32 VoiceMixMismatches = 0;
+
+template< int InterpType >
+static void MixVoiceBatchChecked( VoiceMixSet& dest, const VoiceBatch& batch )
+{
+	VoiceMixSet ref( VoiceMixSet::Empty );
+	MixVoiceBatchScalar<InterpType>( ref, batch );
+
+	if( VoiceMixer == VoiceMixer_Compare )
+	{
+		VoiceMixSet vec( VoiceMixSet::Empty );
+		MixVoiceBatch<InterpType>( vec, batch );
+
+		if( vec.Dry.Left != ref.Dry.Left || vec.Dry.Right != ref.Dry.Right ||
+			vec.Wet.Left != ref.Wet.Left || vec.Wet.Right != ref.Wet.Right )
+		{
+			VoiceMixMismatches++;
+		}
+	}
+
+	dest.Dry.Left	+= ref.Dry.Left;
+	dest.Dry.Right	+= ref.Dry.Right;
+	dest.Wet.Left	+= ref.Wet.Left;
+	dest.Wet.Right	+= ref.Wet.Right;
+}
+
+const VoiceMixSet VoiceMixSet::Empty( (StereoOut32()), (StereoOut32()) );	// Don't use SteroOut32::Empty because C++ doesn't make any dep/order checks on global initializers.
+
+// Mixes the voices of a core for count samples, voice by voice: each voice is run through all of
+// the samples before the next one starts.  With a count of one that's the plain per-sample order.
+template< int InterpType >
+static __forceinline void MixCoreVoices( VoiceMixSet* dest, const uint coreidx, const uint count )
+{
 	for( uint voiceidx=0; voiceidx<V_Core::NumVoices; ++voiceidx )
 	{
-		StereoOut32 VVal( MixVoice( coreidx, voiceidx ) );
+		for( uint i=0; i<count; ++i )
+		{
+			DeferIrqPos = i;
+			PrepareVoice<InterpType>( s_VoiceBatch[i], coreidx, voiceidx, (OutPos + i) & 0x1ff );
+		}
+	}
+
+	for( uint i=0; i<count; ++i )
+	{
+		if( VoiceMixer == VoiceMixer_SSE2 )
+			MixVoiceBatch<InterpType>( dest[i], s_VoiceBatch[i] );
+		else
+			MixVoiceBatchChecked<InterpType>( dest[i], s_VoiceBatch[i] );
+	}
+}
 
-		// Note: Results from MixVoice are ranged at 16 bits.
+static __forceinline void MixCoreVoices( VoiceMixSet* dest, const uint coreidx, const uint count )
+{
+	// Optimization : Forceinline'd Templated Dispatch Table.  Any halfwit compiler will
+	// turn this into a clever jump dispatch table (no call/rets, no compares, uber-efficient!)
+
+	switch( Interpolation )
+	{
+		case 0: MixCoreVoices<0>( dest, coreidx, count ); break;
+		case 1: MixCoreVoices<1>( dest, coreidx, count ); break;
+		case 2: MixCoreVoices<2>( dest, coreidx, count ); break;
+		case 3: MixCoreVoices<3>( dest, coreidx, count ); break;
+		case 4: MixCoreVoices<4>( dest, coreidx, count ); break;
 
-		dest.Dry.Left	+= VVal.Left	& thiscore.VoiceGates[voiceidx].DryL;
-		dest.Dry.Right	+= VVal.Right	& thiscore.VoiceGates[voiceidx].DryR;
-		dest.Wet.Left	+= VVal.Left	& thiscore.VoiceGates[voiceidx].WetL;
-		dest.Wet.Right	+= VVal.Right	& thiscore.VoiceGates[voiceidx].WetR;
+		jNO_DEFAULT;
 	}
 }
 
@@ -817,34 +1100,26 @@ StereoOut32 Apply_Dealias_Filter(StereoOut32 &SoundStream)
 // used to throttle the output rate of cache stat reports
 static int p_cachestat_counter=0;
 
-// Gcc does not want to inline it when lto is enabled because some functions growth too much.
-// The function is big enought to see any speed impact. -- Gregory
-#ifndef __linux__
-__forceinline
-#endif
-void Mix()
+static __forceinline void MixInput( StereoOut32* InputData )
 {
 	// Note: Playmode 4 is SPDIF, which overrides other inputs.
-	StereoOut32 InputData[2] =
-	{
-		// SPDIF is on Core 0:
-		// Fixme: 
-		// 1. We do not have an AC3 decoder for the bitstream. 
-		// 2. Games usually provide a normal ADMA stream as well and want to see it getting read!
-		/*(PlayMode&4) ? StereoOut32::Empty : */ApplyVolume( Cores[0].ReadInput(), Cores[0].InpVol ),
 
-		// CDDA is on Core 1:
-		(PlayMode&8) ? StereoOut32::Empty : ApplyVolume( Cores[1].ReadInput(), Cores[1].InpVol )
-	};
+	// SPDIF is on Core 0:
+	// Fixme: 
+	// 1. We do not have an AC3 decoder for the bitstream. 
+	// 2. Games usually provide a normal ADMA stream as well and want to see it getting read!
+	InputData[0] = /*(PlayMode&4) ? StereoOut32::Empty : */ApplyVolume( Cores[0].ReadInput(), Cores[0].InpVol );
+
+	// CDDA is on Core 1:
+	InputData[1] = (PlayMode&8) ? StereoOut32::Empty : ApplyVolume( Cores[1].ReadInput(), Cores[1].InpVol );
 
 	WaveDump::WriteCore( 0, CoreSrc_Input, InputData[0] );
 	WaveDump::WriteCore( 1, CoreSrc_Input, InputData[1] );
+}
 
-	// Todo: Replace me with memzero initializer!
-	VoiceMixSet VoiceData[2] = { VoiceMixSet::Empty, VoiceMixSet::Empty };	// mixed voice data for each core.
-	MixCoreVoices( VoiceData[0], 0 );
-	MixCoreVoices( VoiceData[1], 1 );
-
+// Everything after the voices: the cores' own mix (input, reverb, master volume) and the output.
+static __forceinline void MixOutput( const StereoOut32* InputData, const VoiceMixSet* VoiceData )
+{
 	StereoOut32 Ext( Cores[0].Mix( VoiceData[0], InputData[0], StereoOut32::Empty ) );
 
 	if( (PlayMode & 4) || (Cores[0].Mute!=0) )
@@ -927,6 +1202,154 @@ void Mix()
 	}
 }
 
+// Gcc does not want to inline it when lto is enabled because some functions growth too much.
+// The function is big enought to see any speed impact. -- Gregory
+#ifndef __linux__
+__forceinline
+#endif
+void Mix()
+{
+	StereoOut32 InputData[2];
+	MixInput( InputData );
+
+	// Todo: Replace me with memzero initializer!
+	VoiceMixSet VoiceData[2] = { VoiceMixSet::Empty, VoiceMixSet::Empty };	// mixed voice data for each core.
+	MixCoreVoices( &VoiceData[0], 0, 1 );
+	MixCoreVoices( &VoiceData[1], 1, 1 );
+
+	MixOutput( InputData, VoiceData );
+}
+
+// Whether the cores may write to any of size halfwords from addr while mixing.
+static __forceinline bool IsCoreWritten( u32 addr, u32 size )
+{
+	// Wrapping around the end of memory lands in the dynamic area as well.
+	if( addr < SPU2_DYN_MEMLINE || addr + size > 0x100000 ) return true;
+
+	for( uint coreidx=0; coreidx<2; ++coreidx )
+	{
+		const V_Core& thiscore( Cores[coreidx] );
+
+		if( thiscore.FxEnable && (addr <= thiscore.EffectsEndA) && (addr + size > thiscore.EffectsStartA) ) return true;
+	}
+
+	return false;
+}
+
+bool MixSpans = true;
+
+// ADPCM blocks first..last that a voice may decode within a span.
+struct SpanBlocks
+{
+	u32 first;
+	u32 last;
+	uint voice;		// coreidx * NumVoices + voiceidx
+};
+
+static bool SpanBlocksBefore( const SpanBlocks& a, const SpanBlocks& b )
+{
+	return a.first < b.first;
+}
+
+// Whether the voices can be run through the next count samples ahead of the rest of the mixer
+// (see MixSpan).  Not when a voice is waiting for its key on delay or uses the noise generator
+// (shared by all voices, so the order of the calls matters), or when a voice could read memory
+// written by the cores while mixing: the dynamic area (sound data input, voice and core output)
+// and the reverb work areas.
+//
+// Nor when two voices could both decode a block that isn't in the PCM cache yet: the first one
+// to get there decodes it with its own ADPCM history and caches the result, which the second
+// then plays.  MixSpan runs the voices one after the other, so the first one to get there may
+// not be the same as when mixing sample by sample.
+bool CanMixSpan( uint count )
+{
+	if( Cores[0].KeyOn || Cores[1].KeyOn ) return false;
+
+	// At most 16 ADPCM samples per output sample (pitch 0xffff), never more than one block.
+	const u32 reach = (count + 1) * 8;
+
+	SpanBlocks blocks[2 * 2 * V_Core::NumVoices];
+	uint blockcount = 0;
+
+	for( uint coreidx=0; coreidx<2; ++coreidx )
+	{
+		for( uint voiceidx=0; voiceidx<V_Core::NumVoices; ++voiceidx )
+		{
+			const V_Voice& vc( Cores[coreidx].Voices[voiceidx] );
+
+			if( vc.Noise && vc.ADSR.Phase > 0 ) return false;
+
+			// A voice only moves forward from NextA, or jumps back to LoopStartA.
+			if( IsCoreWritten( vc.NextA & ~7, reach ) || IsCoreWritten( vc.LoopStartA & ~7, reach ) ) return false;
+
+			// Voices that are off don't decode anything, and can't be keyed on during the span.
+			if( vc.ADSR.Phase <= 0 ) continue;
+
+			const uint voice = coreidx * V_Core::NumVoices + voiceidx;
+			const SpanBlocks fromNext = { vc.NextA / pcm_WordsPerBlock, vc.NextA / pcm_WordsPerBlock + count, voice };
+			const SpanBlocks fromLoop = { vc.LoopStartA / pcm_WordsPerBlock, vc.LoopStartA / pcm_WordsPerBlock + count, voice };
+
+			blocks[blockcount++] = fromNext;
+			blocks[blockcount++] = fromLoop;
+		}
+	}
+
+	std::sort( blocks, blocks + blockcount, SpanBlocksBefore );
+
+	for( uint i=0; i<blockcount; ++i )
+	{
+		for( uint j=i+1; j<blockcount && blocks[j].first <= blocks[i].last; ++j )
+		{
+			if( blocks[j].voice == blocks[i].voice ) continue;
+
+			const u32 last = std::min( blocks[i].last, blocks[j].last );
+
+			for( u32 block = blocks[j].first; block <= last; ++block )
+				if( !pcm_cache_data[block].Validated ) return false;
+		}
+	}
+
+	return true;
+}
+
+// Mixes count samples in one go, for TimeUpdate.  The voices of each core are run through the
+// whole span first, one voice at a time, then the cores mix the inputs, voices and reverb sample
+// by sample.  Voice IRQs are held back meanwhile, and raised again on the sample they happened
+// on.  Callers make sure CanMixSpan holds and no DMA interrupt is due within the span.
+void MixSpan( uint count )
+{
+	static VoiceMixSet CoreVoices[2][MixSpanMax];
+
+	pxAssert( count <= MixSpanMax );
+
+	for( uint i=0; i<count; ++i )
+		CoreVoices[0][i] = CoreVoices[1][i] = VoiceMixSet::Empty;
+
+	DeferIrqs = true;
+	DeferredIrq[0] = DeferredIrq[1] = MixSpanMax;
+
+	MixCoreVoices( CoreVoices[0], 0, count );
+	MixCoreVoices( CoreVoices[1], 1, count );
+
+	DeferIrqs = false;
+
+	for( uint i=0; i<count; ++i )
+	{
+		FlushIrqCall();
+		Cycles++;
+
+		StereoOut32 InputData[2];
+		MixInput( InputData );
+
+		// Where the per-sample mixer would have raised them: after reading the inputs.
+		if( DeferredIrq[0] == i ) SetIrqCall( 0 );
+		if( DeferredIrq[1] == i ) SetIrqCall( 1 );
+
+		const VoiceMixSet Voices[2] = { CoreVoices[0][i], CoreVoices[1][i] };
+		MixOutput( InputData, Voices );
+	}
+}
+
 /////////////////////////////////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////////////////////////////////
 //                                                                                     //
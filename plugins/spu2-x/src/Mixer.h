@@ -132,7 +132,28 @@ struct FrequencyResponseFilter
 
 };
 
+// Voice mixer selection.  The SSE2 kernel is the default; the scalar reference and the compare
+// mode (which runs both, outputs the reference and counts the core mixes that differ in
+// VoiceMixMismatches) are there for checking the kernel, e.g. through the headless s2r replay.
+enum VoiceMixerType
+{
+	VoiceMixer_SSE2 = 0,
+	VoiceMixer_Scalar,
+	VoiceMixer_Compare,
+};
+
+extern int	VoiceMixer;
+extern u32	VoiceMixMismatches;
+
+// Longest span of samples MixSpan can do in one go.
+static const uint MixSpanMax = 16;
+
+// Lets TimeUpdate mix whole spans of samples; when cleared, every sample goes through Mix().
+extern bool	MixSpans;
+
 extern void	Mix();
+extern bool	CanMixSpan( uint count );
+extern void	MixSpan( uint count );
 extern s32	clamp_mix( s32 x, u8 bitshift=0 );
 
 extern StereoOut32 clamp_mix( const StereoOut32& sample, u8 bitshift=0 );
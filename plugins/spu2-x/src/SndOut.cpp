@@ -115,8 +115,9 @@ int FindOutputModuleById( const wchar_t* omodid )
 
 StereoOut32 *SndBuffer::m_buffer;
 s32 SndBuffer::m_size;
-__aligned(4) volatile s32 SndBuffer::m_rpos;
-__aligned(4) volatile s32 SndBuffer::m_wpos;
+SndBufferIndex SndBuffer::m_rpos;
+SndBufferIndex SndBuffer::m_wpos;
+SndBufferStats SndBuffer::m_stats;
 
 bool SndBuffer::m_underrun_freeze;
 StereoOut32* SndBuffer::sndTempBuffer = NULL;
@@ -135,6 +136,8 @@ bool SndBuffer::CheckUnderrunStatus( int& nSamples, int& quietSampleCount )
 	quietSampleCount = 0;
 
 	int data = _GetApproximateDataInBuffer();
+	_UpdateLatencyStats( data );
+
 	if( m_underrun_freeze )
 	{
 		int toFill = m_size / ( (SynchMode == 2) ? 32 : 400); // TimeStretch and Async off?
@@ -158,6 +161,7 @@ bool SndBuffer::CheckUnderrunStatus( int& nSamples, int& quietSampleCount )
 		nSamples = data;
 		quietSampleCount = SndOutPacketSize - data;
 		m_underrun_freeze = true;
+		m_stats.Underruns++;
 
 		if( SynchMode == 0 ) // TimeStrech on
 			timeStretchUnderrun();
@@ -179,7 +183,37 @@ void SndBuffer::_InitFail()
 int SndBuffer::_GetApproximateDataInBuffer()
 {
 	// WARNING: not necessarily 100% up to date by the time it's used, but it will have to do.
-	return (m_wpos + m_size - m_rpos) % m_size;
+	// Each side reads the other side's index only once, and the barrier keeps the compiler
+	// from touching the buffer before it's known to be safe.
+	const int data = (m_wpos.pos + m_size - m_rpos.pos) % m_size;
+	_ReadWriteBarrier();
+	return data;
+}
+
+void SndBuffer::_UpdateLatencyStats( int data )
+{
+	int ms = (int)( (s64)data * 1000 / SampleRate ) >> 2;
+	int bucket = 0;
+
+	while( ms > 0 && bucket < SndBufferStats::LatencyBuckets - 1 )
+	{
+		ms >>= 1;
+		bucket++;
+	}
+
+	m_stats.Latency[bucket]++;
+}
+
+void SndBuffer::GetStats( SndBufferStats& dest )
+{
+	// The counters are each only written by one side of the ring, so a plain copy is
+	// good enough for reporting purposes.
+	memcpy( &dest, &m_stats, sizeof(dest) );
+}
+
+void SndBuffer::ResetStats()
+{
+	memset( &m_stats, 0, sizeof(m_stats) );
 }
 
 void SndBuffer::_WriteSamples_Internal(StereoOut32 *bData, int nSamples)
@@ -187,29 +221,34 @@ void SndBuffer::_WriteSamples_Internal(StereoOut32 *bData, int nSamples)
 	// WARNING: This assumes the write will NOT wrap around,
 	// and also assumes there's enough free space in the buffer.
 
-	memcpy(m_buffer + m_wpos, bData, nSamples * sizeof(StereoOut32));
-	m_wpos = (m_wpos + nSamples) % m_size;
+	memcpy(m_buffer + m_wpos.pos, bData, nSamples * sizeof(StereoOut32));
+
+	// Publish the samples only once they're all in the buffer.
+	_ReadWriteBarrier();
+	m_wpos.pos = (m_wpos.pos + nSamples) % m_size;
 }
 
 void SndBuffer::_DropSamples_Internal(int nSamples)
 {
-	m_rpos = (m_rpos + nSamples) % m_size;
+	// Hand the space back to the writer only once we're done reading from it.
+	_ReadWriteBarrier();
+	m_rpos.pos = (m_rpos.pos + nSamples) % m_size;
 }
 
 void SndBuffer::_ReadSamples_Internal(StereoOut32 *bData, int nSamples)
 {
 	// WARNING: This assumes the read will NOT wrap around,
 	// and also assumes there's enough data in the buffer.
-	memcpy(bData, m_buffer + m_rpos, nSamples * sizeof(StereoOut32));
+	memcpy(bData, m_buffer + m_rpos.pos, nSamples * sizeof(StereoOut32));
 	_DropSamples_Internal(nSamples);
 }
 
 void SndBuffer::_WriteSamples_Safe(StereoOut32 *bData, int nSamples)
 {
 	// WARNING: This code assumes there's only ONE writing process.
-	if( (m_size - m_wpos) < nSamples)
+	if( (m_size - m_wpos.pos) < nSamples)
 	{
-		int b1 = m_size - m_wpos;
+		int b1 = m_size - m_wpos.pos;
 		int b2 = nSamples - b1;
 
 		_WriteSamples_Internal(bData, b1);
@@ -224,9 +263,9 @@ void SndBuffer::_WriteSamples_Safe(StereoOut32 *bData, int nSamples)
 void SndBuffer::_ReadSamples_Safe(StereoOut32* bData, int nSamples)
 {
 	// WARNING: This code assumes there's only ONE reading process.
-	if( (m_size - m_rpos) < nSamples)
+	if( (m_size - m_rpos.pos) < nSamples)
 	{
-		int b1 = m_size - m_rpos;
+		int b1 = m_size - m_rpos.pos;
 		int b2 = nSamples - b1;
 
 		_ReadSamples_Internal(bData, b1);
@@ -265,7 +304,8 @@ template<typename T> void SndBuffer::ReadSamples(T* bData)
 		jASSUME( nSamples <= SndOutPacketSize );
 		
 		// WARNING: This code assumes there's only ONE reading process.
-		int b1 = m_size - m_rpos;
+		const int rpos = m_rpos.pos;
+		int b1 = m_size - rpos;
 
 		if(b1 > nSamples)
 			b1 = nSamples;
@@ -274,7 +314,7 @@ template<typename T> void SndBuffer::ReadSamples(T* bData)
 		{
 			// First part
 			for (int i = 0; i < b1; i++)
-				bData[i].AdjustFrom(m_buffer[i + m_rpos]);
+				bData[i].AdjustFrom(m_buffer[i + rpos]);
 
 			// Second part
 			int b2 = nSamples - b1;
@@ -285,7 +325,7 @@ template<typename T> void SndBuffer::ReadSamples(T* bData)
 		{
 			// First part
 			for (int i = 0; i < b1; i++)
-				bData[i].ResampleFrom(m_buffer[i + m_rpos]);
+				bData[i].ResampleFrom(m_buffer[i + rpos]);
 
 			// Second part
 			int b2 = nSamples - b1;
@@ -366,6 +406,7 @@ void SndBuffer::_WriteSamples(StereoOut32 *bData, int nSamples)
 			ConLog(" * SPU2 > Overrun Compensation (%d packets tossed)\n", comp / SndOutPacketSize );
 		lastPct = 0.0;		// normalize the timestretcher
 #else
+		m_stats.Overruns++;
 		if( MsgOverruns() )
 			ConLog(" * SPU2 > Overrun! 1 packet tossed)\n");
 		lastPct = 0.0;		// normalize the timestretcher
@@ -388,8 +429,9 @@ void SndBuffer::Init()
 	// Buffer actually attempts to run ~50%, so allocate near double what
 	// the requested latency is:
 	
-	m_rpos = 0;
-	m_wpos = 0;
+	m_rpos.pos = 0;
+	m_wpos.pos = 0;
+	ResetStats();
 
 	try
 	{
@@ -418,6 +460,7 @@ void SndBuffer::Init()
 	sndTempProgress = 0;
 
 	soundtouchInit();		// initializes the timestretching
+	dspThreadInit();
 
 	// initialize module
 	if( mods[OutputModule]->Init() == -1 ) _InitFail();
@@ -427,6 +470,16 @@ void SndBuffer::Cleanup()
 {
 	mods[OutputModule]->Close();
 
+	if( MsgOverruns() )
+	{
+		ConLog( "* SPU2-X: SndBuffer: %u underruns, %u overruns, %u dropped; latency histogram (<4ms, <8ms, ... >=256ms):",
+			m_stats.Underruns, m_stats.Overruns, m_stats.Dropped );
+		for( int i=0; i<SndBufferStats::LatencyBuckets; ++i )
+			ConLog( " %u", m_stats.Latency[i] );
+		ConLog( "\n" );
+	}
+
+	dspThreadCleanup();
 	soundtouchCleanup();
 
 	safe_delete_array( m_buffer );
@@ -441,7 +494,10 @@ int SndBuffer::ssFreeze = 0;
 
 void SndBuffer::ClearContents()
 {
-	SndBuffer::soundtouchClearContents();
+	if( m_dspQueue != NULL )
+		m_dspClear = true;		// the DSP thread owns the timestretcher, let it do the clearing
+	else
+		SndBuffer::soundtouchClearContents();
 	SndBuffer::ssFreeze = 256; //Delays sound output for about 1 second.
 }
 
@@ -483,7 +539,7 @@ void SndBuffer::Write( const StereoOut32& Sample )
 			for( int i=0; i<SndOutPacketSize; ++i, ++ei ) { sndTempBuffer[i] = sndTempBuffer16[ei].UpSample(); }
 
 			if( SynchMode == 0 ) // TimeStrech on
-				timeStretchWrite();
+				timeStretchQueue();
 			else
 				_WriteSamples(sndTempBuffer, SndOutPacketSize);
 
@@ -502,7 +558,7 @@ void SndBuffer::Write( const StereoOut32& Sample )
 	else
 	{
 		if( SynchMode == 0 ) // TimeStrech on
-			timeStretchWrite();
+			timeStretchQueue();
 		else
 			_WriteSamples(sndTempBuffer, SndOutPacketSize);
 	}
@@ -561,8 +561,32 @@ struct Stereo51Out32
 };
 
 // Developer Note: This is a static class only (all static members).
+// Statistics of the SndBuffer ring, as seen by the output module's reads.
+struct SndBufferStats
+{
+	// Latency histogram, in amount of audio queued up when the output module reads a
+	// packet: bucket 0 counts reads that found less than 4 ms, each following bucket
+	// doubles the range (4-8 ms, 8-16 ms, ...), and the last one counts 256 ms and up.
+	static const int LatencyBuckets = 8;
+
+	u32 Underruns;
+	u32 Overruns;
+	u32 Dropped;		// packets dropped because the DSP thread fell behind
+	u32 Latency[LatencyBuckets];
+};
+
+// Each ring index gets a cache line of its own, so the mixer and the output thread don't
+// keep stealing the line from each other.
+struct __aligned(64) SndBufferIndex
+{
+	volatile s32 pos;
+	u8 _pad[64 - sizeof(s32)];
+};
+
 class SndBuffer
 {
+	friend class SndDspThread;
+
 private:
 	static bool m_underrun_freeze;
 	static s32 m_predictData;
@@ -580,8 +604,22 @@ private:
 	static StereoOut32 *m_buffer;
 	static s32 m_size;
 
-	static __aligned(4) volatile s32 m_rpos;
-	static __aligned(4) volatile s32 m_wpos;
+	// Single producer (Write, on the SPU2 thread) / single consumer (ReadSamples, on the
+	// output module's thread) ring.  Each side only stores its own index, and publishes it
+	// after it's done with the samples, so neither side ever needs a lock.
+	static SndBufferIndex m_rpos;
+	static SndBufferIndex m_wpos;
+
+	static SndBufferStats m_stats;
+
+	// Mixed packets waiting for the DSP thread, which runs the timestretcher so the SPU2
+	// thread doesn't have to.  Same single producer/single consumer scheme as above.
+	static const int DspQueuePackets = 128;
+
+	static StereoOut32* m_dspQueue;
+	static SndBufferIndex m_dspRpos;
+	static SndBufferIndex m_dspWpos;
+	static volatile bool m_dspClear;
 	
 	static float lastEmergencyAdj;
 	static float cTempo;
@@ -594,7 +632,11 @@ private:
 	static void soundtouchInit();
 	static void soundtouchClearContents();
 	static void soundtouchCleanup();
-	static void timeStretchWrite();
+	static void timeStretchWrite( StereoOut32* packet );
+	static void timeStretchQueue();
+	static void timeStretchProcessQueue();
+	static void dspThreadInit();
+	static void dspThreadCleanup();
 	static void timeStretchUnderrun();
 	static s32 timeStretchOverrun();
 
@@ -613,6 +655,7 @@ private:
 	static void _ReadSamples_Internal(StereoOut32 *bData, int nSamples);
 
 	static int _GetApproximateDataInBuffer(); 
+	static void _UpdateLatencyStats( int data );
 	
 public:
 	static void UpdateTempoChangeAsyncMixing();
@@ -622,6 +665,9 @@ public:
 	static s32 Test();
 	static void ClearContents();
 
+	static void GetStats( SndBufferStats& dest );
+	static void ResetStats();
+
 	// Note: When using with 32 bit output buffers, the user of this function is responsible
 	// for shifting the values to where they need to be manually.  The fixed point depth of
 	// the sample output is determined by the SndOutVolumeShift, which is the number of bits
@@ -685,7 +731,7 @@ extern SndOutModule* mods[];
 
 extern bool WavRecordEnabled;
 
-extern void RecordStart();
+extern void RecordStart( const char* filename = "recording.wav" );
 extern void RecordStop();
 extern void RecordWrite( const StereoOut16& sample );
 
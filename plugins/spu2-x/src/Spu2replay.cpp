@@ -18,6 +18,7 @@
 
 #include "Global.h"
 #include "PS2E-spu2.h"
+#include "Utilities/General.h"
 
 #ifdef _MSC_VER
 #	include "Windows.h"
@@ -105,6 +106,24 @@ double HighResScale;
 
 bool Running = false;
 
+void dummy1()
+{
+}
+
+void dummy4()
+{
+#ifndef ENABLE_NEW_IOPDMA_SPU2
+	SPU2interruptDMA4();
+#endif
+}
+
+void dummy7()
+{
+#ifndef ENABLE_NEW_IOPDMA_SPU2
+	SPU2interruptDMA7();
+#endif
+}
+
 #ifdef _MSC_VER
 
 int conprintf(const char* fmt, ...)
@@ -135,24 +154,6 @@ int conprintf(const char* fmt, ...)
 #endif
 }
 
-void dummy1()
-{
-}
-
-void dummy4()
-{
-#ifndef ENABLE_NEW_IOPDMA_SPU2
-	SPU2interruptDMA4();
-#endif
-}
-
-void dummy7()
-{
-#ifndef ENABLE_NEW_IOPDMA_SPU2
-	SPU2interruptDMA7();
-#endif
-}
-
 u64 HighResFrequency()
 {
 	u64 freq;
@@ -316,4 +317,150 @@ Finish:
 	replay_mode=false;
 #endif
 }
+
+#else
+
+// Headless replay: runs a recorded stream through the mixer as fast as possible, with no
+// output device and no pacing, and records the final mix to a wav file.  Meant to be
+// called from a small harness that dlopen()s the plugin (pcsx2_SPU2ReplayLoader), as a
+// deterministic benchmark (and, comparing the wav files, a regression test) of the audio core.
+//
+// mixer selects the voice mixer (see VoiceMixerType): VoiceMixer_Compare runs the SSE2 kernel
+// and the scalar reference side by side, and fails the replay if any core mix differs.  With
+// spans cleared, every sample is mixed on its own (see MixSpans).  That must give the very same
+// wav file, which the loader's --check-spans mode checks.
+//
+// Returns the number of samples mixed per second of wall time, or -1 on error.
+EXPORT_C_(double) s2r_replay_headless(const char* filename, const char* wavfile, int mixer, int spans)
+{
+#ifndef ENABLE_NEW_IOPDMA_SPU2
+	int events=0;
+
+	FILE *file=fopen(filename,"rb");
+
+	if(!file)
+	{
+		ConLog("* SPU2-X: Could not open the replay file %s.\n",filename);
+		return -1;
+	}
+
+#define TryRead(dest,size,count,file) if(fread(dest,size,count,file)<count) { goto Finish; }
+
+	u32 StartTicks = 0;
+	u64 TotalCycles = 0;
+	u64 StartTime = 0, EndTime = 0;
+
+	if(fread(&StartTicks,4,1,file)<1)
+	{
+		ConLog("* SPU2-X: Error reading from the replay file %s.\n",filename);
+		fclose(file);
+		return -1;
+	}
+
+	replay_mode=true;
+
+	VoiceMixer = mixer;
+	VoiceMixMismatches = 0;
+	MixSpans = !!spans;
+
+	SPU2init();
+	SPU2irqCallback(dummy1,dummy4,dummy7);
+	SPU2setClockPtr(&CurrentIOPCycle);
+
+	// No output device: SndBuffer::Write bails out right after recording the sample, so
+	// only the emulation of the audio core itself is measured.
+	OutputModule = FindOutputModuleById( L"nullout" );
+	SPU2open(NULL);
+	RecordStart(wavfile);
+
+	CurrentIOPCycle=0;
+
+	SPU2async(0);
+
+	StartTime = GetCPUTicks();
+
+	while(!feof(file))
+	{
+		u32 ccycle=0;
+		u32 evid=0;
+		u32 sval=0;
+		u32 tval=0;
+
+		TryRead(&ccycle,4,1,file);
+		TryRead(&sval,4,1,file);
+
+		evid=sval>>29;
+		sval&=0x1FFFFFFF;
+
+		u32 TargetCycle = ccycle * 768;
+
+		// Advance in fixed steps of at most 1ms (the paced replay advances by however long
+		// WaitSync slept), so the events always land on the same samples from one run to the
+		// next and TimeUpdate's sanity limits never kick in.
+		while((s32)(TargetCycle - CurrentIOPCycle) > 0)
+		{
+			u32 delta = std::min<u32>(TargetCycle - CurrentIOPCycle, IOPCiclesPerMS);
+			CurrentIOPCycle += delta;
+			TotalCycles += delta;
+			SPU2async(delta);
+		}
+
+		switch(evid)
+		{
+		case 0:
+			SPU2read(sval);
+			break;
+		case 1:
+			TryRead(&tval,2,1,file);
+			SPU2write(sval,tval);
+			break;
+		case 2:
+			TryRead(dmabuffer,sval,2,file);
+			SPU2writeDMA4Mem(dmabuffer,sval);
+			break;
+		case 3:
+			TryRead(dmabuffer,sval,2,file);
+			SPU2writeDMA7Mem(dmabuffer,sval);
+			break;
+		default:
+			ConLog("* SPU2-X: Unknown replay event %d, stopping.\n",evid);
+			goto Finish;
+		}
+		events++;
+	}
+
+Finish:
+
+	EndTime = GetCPUTicks();
+
+	RecordStop();
+	SPU2close();
+	SPU2shutdown();
+	fclose(file);
+
+	replay_mode=false;
+
+	const u64 samples = TotalCycles / 768;
+	const double seconds = (double)(EndTime - StartTime) / (double)GetTickFrequency();
+	const double rate = (seconds > 0) ? samples / seconds : 0;
+
+	ConLog("* SPU2-X: Replayed %s (%d events, %llu samples) in %.3f s: %.0f samples/sec (%.1fx realtime).\n",
+		filename, events, (unsigned long long)samples, seconds, rate, rate / SampleRate);
+
+	const int mismatches = VoiceMixMismatches;
+
+	VoiceMixer = VoiceMixer_SSE2;
+	MixSpans = true;
+
+	if(mixer == VoiceMixer_Compare)
+	{
+		ConLog("* SPU2-X: Voice mixer check: %d core mixes differ from the scalar reference.\n", mismatches);
+		if(mismatches) return -1;
+	}
+
+	return rate;
+#else
+	return -1;
+#endif
+}
 #endif
@@ -17,6 +17,7 @@
 
 #include "Global.h"
 #include "soundtouch/SoundTouch.h"
+#include "Utilities/PersistentThread.h"
 #include <wx/datetime.h>
 #include <algorithm>
 
@@ -239,6 +240,15 @@ void SndBuffer::UpdateTempoChangeSoundTouch2()
 				(int)(data/48), (double)(100.0*bufferFullness/baseTargetFullness), (double)tempoAdjust, (double)(dynamicTargetFullness/baseTargetFullness), iters, (int)targetIPS
 				, AVERAGING_WINDOW, hys_min_ok_count, compensationDivider, gRequestStretcherReset
 				);
+
+			C_ASSERT( SndBufferStats::LatencyBuckets == 8 );
+			SndBufferStats stats;
+			GetStats( stats );
+			ConLog("ring: %u underruns, %u overruns, %u dropped, latency (<4ms ... >=256ms): %u %u %u %u %u %u %u %u\n",
+				stats.Underruns, stats.Overruns, stats.Dropped,
+				stats.Latency[0], stats.Latency[1], stats.Latency[2], stats.Latency[3],
+				stats.Latency[4], stats.Latency[5], stats.Latency[6], stats.Latency[7]
+				);
 			last=unow;
 			iters=0;
 		}
@@ -460,7 +470,7 @@ static void CvtPacketToInt( StereoOut32* srcdest, uint size )
 		*dest = (StereoOut32)*src;
 }
 
-void SndBuffer::timeStretchWrite()
+void SndBuffer::timeStretchWrite( StereoOut32* packet )
 {
 	// data prediction helps keep the tempo adjustments more accurate.
 	// The timestretcher returns packets in belated "clump" form.
@@ -469,19 +479,19 @@ void SndBuffer::timeStretchWrite()
 	// data prediction to make the timestretcher more responsive.
 
 	PredictDataWrite( (int)( SndOutPacketSize / eTempo ) );
-	CvtPacketToFloat( sndTempBuffer );
+	CvtPacketToFloat( packet );
 
-	pSoundTouch->putSamples( (float*)sndTempBuffer, SndOutPacketSize );
+	pSoundTouch->putSamples( (float*)packet, SndOutPacketSize );
 
 	int tempProgress;
-	while( tempProgress = pSoundTouch->receiveSamples( (float*)sndTempBuffer, SndOutPacketSize),
+	while( tempProgress = pSoundTouch->receiveSamples( (float*)packet, SndOutPacketSize),
 		tempProgress != 0 )
 	{
 		// Hint: It's assumed that pSoundTouch will return chunks of 128 bytes (it always does as
 		// long as the SSE optimizations are enabled), which means we can do our own SSE opts here.
 
-		CvtPacketToInt( sndTempBuffer, tempProgress );
-		_WriteSamples( sndTempBuffer, tempProgress );
+		CvtPacketToInt( packet, tempProgress );
+		_WriteSamples( packet, tempProgress );
 	}
 
 #ifdef SPU2X_USE_OLD_STRETCHER
@@ -535,3 +545,134 @@ void SndBuffer::soundtouchCleanup()
 {
 	safe_delete( pSoundTouch );
 }
+
+// --------------------------------------------------------------------------------------
+//  SndDspThread
+// --------------------------------------------------------------------------------------
+// Runs the timestretcher off the SPU2 thread: Write() only queues the mixed packets, and
+// this thread stretches them into the output ring.  SoundTouch gets expensive precisely
+// when the game already runs below full speed, so the emulation shouldn't pay for it.
+
+class SndDspThread : public Threading::pxThread
+{
+	typedef pxThread _parent;
+
+public:
+	SndDspThread() : _parent( L"SPU2-X DSP" )
+	{
+	}
+
+	virtual ~SndDspThread() throw()
+	{
+		_parent::Cancel();
+	}
+
+	void Wake()
+	{
+		m_sem_event.Post();
+	}
+
+protected:
+	void ExecuteTaskInThread()
+	{
+		while( true )
+		{
+			m_sem_event.WaitWithoutYield();
+			SndBuffer::timeStretchProcessQueue();
+		}
+	}
+};
+
+static SndDspThread* pDspThread = NULL;
+
+StereoOut32* SndBuffer::m_dspQueue = NULL;
+SndBufferIndex SndBuffer::m_dspRpos;
+SndBufferIndex SndBuffer::m_dspWpos;
+volatile bool SndBuffer::m_dspClear = false;
+
+void SndBuffer::dspThreadInit()
+{
+	m_dspRpos.pos = 0;
+	m_dspWpos.pos = 0;
+	m_dspClear = false;
+
+	// Only the timestretcher is worth a thread; the other sync modes write straight to
+	// the output ring.
+	if( SynchMode != 0 ) return;
+
+	try
+	{
+		m_dspQueue = new StereoOut32[DspQueuePackets * SndOutPacketSize];
+		pDspThread = new SndDspThread();
+		pDspThread->Start();
+	}
+	catch( Exception::BaseException& )
+	{
+		ConLog( "* SPU2-X: Could not start the DSP thread, timestretching inline instead.\n" );
+		dspThreadCleanup();
+	}
+	catch( std::bad_alloc& )
+	{
+		dspThreadCleanup();
+	}
+}
+
+void SndBuffer::dspThreadCleanup()
+{
+	safe_delete( pDspThread );
+	safe_delete_array( m_dspQueue );
+}
+
+// Called from Write() on the SPU2 thread, with a full packet in sndTempBuffer.
+void SndBuffer::timeStretchQueue()
+{
+	if( m_dspQueue == NULL )
+	{
+		timeStretchWrite( sndTempBuffer );
+		return;
+	}
+
+	const int wpos = m_dspWpos.pos;
+	const int next = (wpos + 1) % DspQueuePackets;
+
+	if( next == m_dspRpos.pos )
+	{
+		// The DSP thread can't keep up (or is stuck), drop the packet rather than stall
+		// the emulation.
+		m_stats.Dropped++;
+		if( MsgOverruns() )
+			ConLog(" * SPU2 > DSP thread fell behind, 1 packet dropped\n");
+		return;
+	}
+
+	_ReadWriteBarrier();
+	memcpy( &m_dspQueue[wpos * SndOutPacketSize], sndTempBuffer, sizeof(StereoOut32) * SndOutPacketSize );
+	_ReadWriteBarrier();
+	m_dspWpos.pos = next;
+
+	pDspThread->Wake();
+}
+
+// Called on the DSP thread: stretches everything queued so far into the output ring.
+void SndBuffer::timeStretchProcessQueue()
+{
+	if( m_dspClear )
+	{
+		// Savestate load or reset: whatever is still queued is stale.
+		m_dspClear = false;
+		m_dspRpos.pos = m_dspWpos.pos;
+		soundtouchClearContents();
+	}
+
+	while( true )
+	{
+		const int rpos = m_dspRpos.pos;
+		if( rpos == m_dspWpos.pos ) break;
+		_ReadWriteBarrier();
+
+		timeStretchWrite( &m_dspQueue[rpos * SndOutPacketSize] );
+
+		_ReadWriteBarrier();
+		m_dspRpos.pos = (rpos + 1) % DspQueuePackets;
+	}
+}
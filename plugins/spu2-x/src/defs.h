@@ -541,6 +541,13 @@ extern s16*		_spu2mem;
 extern int		PlayMode;
 
 extern void SetIrqCall(int core);
+extern void FlushIrqCall();
+
+// Set while MixSpan runs the voices ahead of the cores: IRQs are then only noted in DeferredIrq,
+// with the earliest sample of the span (DeferIrqPos) they happened on.
+extern bool		DeferIrqs;
+extern uint		DeferIrqPos;
+extern uint		DeferredIrq[2];
 extern void StartVoices(int core, u32 value);
 extern void StopVoices(int core, u32 value);
 extern void InitADSR();
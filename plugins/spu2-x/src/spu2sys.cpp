@@ -42,16 +42,37 @@ int		PlayMode;
 
 bool has_to_call_irq=false;
 
+bool	DeferIrqs = false;
+uint	DeferIrqPos = 0;
+uint	DeferredIrq[2];
+
 void SetIrqCall(int core)
 {
 	// reset by an irq disable/enable cycle, behaviour found by
 	// test programs that bizarrely only fired one interrupt
 	if (Spdif.Info & 4 << core)
 		return;
+	if (DeferIrqs)
+	{
+		if (DeferIrqPos < DeferredIrq[core])
+			DeferredIrq[core] = DeferIrqPos;
+		return;
+	}
 	Spdif.Info |= 4 << core;
 	has_to_call_irq=true;
 }
 
+// Calls back the IOP for an IRQ raised while mixing the previous sample.
+void FlushIrqCall()
+{
+	if(has_to_call_irq)
+	{
+		//ConLog("* SPU2-X: Irq Called (%04x) at cycle %d.\n", Spdif.Info, Cycles);
+		has_to_call_irq=false;
+		if(_irqcallback) _irqcallback();
+	}
+}
+
 __forceinline s16* GetMemPtr(u32 addr)
 {
 #ifndef DEBUG_FAST
@@ -75,7 +96,7 @@ __forceinline void spu2M_Write( u32 addr, s16 value )
 	// (note to self : addr address WORDs, not bytes)
 
 	addr &= 0xfffff;
-	if( addr >= SPU2_DYN_MEMLINE )
+	if( addr >= SPU2_DYN_MEMLINE && *GetMemPtr( addr ) != value )
 	{
 		const int cacheIdx = addr / pcm_WordsPerBlock;
 		pcm_cache_data[cacheIdx].Validated = false;
@@ -387,61 +408,100 @@ __forceinline void TimeUpdate(u32 cClocks)
 	//Update Mixing Progress
 	while(dClocks>=TickInterval)
 	{
-		if(has_to_call_irq)
-		{
-			//ConLog("* SPU2-X: Irq Called (%04x) at cycle %d.\n", Spdif.Info, Cycles);
-			has_to_call_irq=false;
-			if(_irqcallback) _irqcallback();
-		}
+		// Mix a span of samples that ends no later than the sample where a DMA interrupt delay
+		// counter runs out.  The counters only matter to the IOP, so they are advanced once, on
+		// the last sample of the span, right where the original per-sample update would have
+		// raised the interrupt.
+
+		u32 ticks = dClocks / TickInterval;
 
 #ifndef ENABLE_NEW_IOPDMA_SPU2
-		//Update DMA4 interrupt delay counter
-		if(Cores[0].DMAICounter>0)
+		for (int i = 0; i < 2; i++)
+			if (Cores[i].DMAICounter > 0)
+				ticks = std::min<u32>(ticks, (Cores[i].DMAICounter + TickInterval - 1) / TickInterval);
+
+		const s32 spanClocks = ticks * TickInterval;
+#endif
+
+		while (ticks > 0)
 		{
-			Cores[0].DMAICounter-=TickInterval;
-			if(Cores[0].DMAICounter<=0)
+			// All samples but the last one are free of DMA events, so they are handed to MixSpan
+			// whenever the voices allow it.  Otherwise, and for the last sample, the mixer runs
+			// one sample at a time.  CanMixSpan isn't cheap enough to ask before every sample, so
+			// a refusal is good for a whole span's worth of them.
+
+			u32 count = std::min<u32>(ticks - 1, MixSpanMax);
+
+			if (count > 1 && MixSpans && CanMixSpan(count))
 			{
-				Cores[0].MADR=Cores[0].TADR;
-				Cores[0].DMAICounter=0;
-				if(dma4callback) dma4callback();
-			}
-			else {
-				Cores[0].MADR+=TickInterval<<1;
+				dClocks -= count * TickInterval;
+				lClocks += count * TickInterval;
+				ticks -= count;
+
+				MixSpan(count);
+				continue;
 			}
-		}
 
-		//Update DMA7 interrupt delay counter
-		if(Cores[1].DMAICounter>0)
-		{
-			Cores[1].DMAICounter-=TickInterval;
-			if(Cores[1].DMAICounter<=0)
+			if (count == 0)
+				count = 1;
+
+			for (; count > 0; count--, ticks--)
 			{
-				Cores[1].MADR=Cores[1].TADR;
-				Cores[1].DMAICounter=0;
-				//ConLog( "* SPU2 > DMA 7 Callback!  %d\n", Cycles );
-				if(dma7callback) dma7callback();
-			}
-			else {
-				Cores[1].MADR+=TickInterval<<1;
-			}
-		}
-#endif
+				FlushIrqCall();
 
-		dClocks -= TickInterval;
-		lClocks += TickInterval;
-		Cycles++;
+#ifndef ENABLE_NEW_IOPDMA_SPU2
+				if (ticks == 1)
+				{
+					//Update DMA4 interrupt delay counter
+					if(Cores[0].DMAICounter>0)
+					{
+						Cores[0].DMAICounter-=spanClocks;
+						if(Cores[0].DMAICounter<=0)
+						{
+							Cores[0].MADR=Cores[0].TADR;
+							Cores[0].DMAICounter=0;
+							if(dma4callback) dma4callback();
+						}
+						else {
+							Cores[0].MADR+=spanClocks<<1;
+						}
+					}
+
+					//Update DMA7 interrupt delay counter
+					if(Cores[1].DMAICounter>0)
+					{
+						Cores[1].DMAICounter-=spanClocks;
+						if(Cores[1].DMAICounter<=0)
+						{
+							Cores[1].MADR=Cores[1].TADR;
+							Cores[1].DMAICounter=0;
+							//ConLog( "* SPU2 > DMA 7 Callback!  %d\n", Cycles );
+							if(dma7callback) dma7callback();
+						}
+						else {
+							Cores[1].MADR+=spanClocks<<1;
+						}
+					}
+				}
+#endif
 
-		for (int i = 0; i < 2; i++)
-			if (Cores[i].KeyOn)
-				for (int j = 0; j < 24; j++)
-					if (Cores[i].KeyOn >> j & 1)
-						if (Cores[i].Voices[j].Start())
-							Cores[i].KeyOn &= ~(1 << j);
-
-		// Note: IOP does not use MMX regs, so no need to save them.
-		//SaveMMXRegs();
-		Mix();
-		//RestoreMMXRegs();
+				dClocks -= TickInterval;
+				lClocks += TickInterval;
+				Cycles++;
+
+				for (int i = 0; i < 2; i++)
+					if (Cores[i].KeyOn)
+						for (int j = 0; j < 24; j++)
+							if (Cores[i].KeyOn >> j & 1)
+								if (Cores[i].Voices[j].Start())
+									Cores[i].KeyOn &= ~(1 << j);
+
+				// Note: IOP does not use MMX regs, so no need to save them.
+				//SaveMMXRegs();
+				Mix();
+				//RestoreMMXRegs();
+			}
+		}
 	}
 }
 